@@ -8,18 +8,29 @@ BMSSP::BMSSPReturn BMSSP::BMSSP_recurse(Parameters lkt, Length B, ShpBlock S) {
     // Implemented as algorithm 3 in the paper.
     if (l == 0) { return BMSSP_basecase({ 0, k, t }, B, S); }
 
+    // Buffers allocated by this frame, including P and W, are released on return.
+    VertexArena::Frame frame(vertexArena);
+
     auto [P, W] = FindPivot(lkt, B, S);
 
     size_t M = (size_t(1) << ((l - 1) * t)); // M = 2^((l-1)*t).
     size_t largeWorkload = k << (l * t); // largeWorkload = k * 2^(l*t).
-    FrontierManager D(*this, M, B);
-
-    D.insert(std::move(P));
+    // The frontier D of this level, of the backend picked by frontierPolicy, constructed in place.
+    std::optional<FrontierManager> blockFrontier;
+    std::optional<HeapFrontier> heapFrontier;
+    std::optional<RadixFrontier> radixFrontier;
+    Frontier& D = (frontierPolicy(l) == FrontierKind::BinaryHeap)
+        ? static_cast<Frontier&>(heapFrontier.emplace(*this, frontierHeaps[l], M, B))
+        : (frontierPolicy(l) == FrontierKind::Radix)
+        ? static_cast<Frontier&>(radixFrontier.emplace(*this, frontierBuckets[l], M, B))
+        : blockFrontier.emplace(*this, M, B);
+
+    D.insert(P);
 
     // i in the paper is merely for better specification and clearer proof.
     // No need to introduce in the code.
     Length Bprime = D.getCurrentLowerBound(); // Now Bprime is B_0' in the paper.
-    ShpBlock U = std::make_shared<Block>(newList(), B, Bprime, largeWorkload);
+    ShpBlock U = newBlock(newList(), B, Bprime, largeWorkload);
 
     while (true) {
         auto [Bi, S] = D.pull();
@@ -33,21 +44,25 @@ BMSSP::BMSSPReturn BMSSP::BMSSP_recurse(Parameters lkt, Length B, ShpBlock S) {
             break;
         }
 
-        ShpBlock K = std::make_shared<Block>(newList(), Bi, Bprime, M);
+        ShpBlock K = newBlock(newList(), Bi, Bprime, M);
         // Update Ui's out degrees.
-        for (auto u : *Ui) {
-            for (auto [v, weight_uv] : constDegGraph.getNeighbors(u)) {
-                Length relax = dhat[u].relax(v, weight_uv);
-                if (relax <= dhat[v] && relax < B) {
-                    dhat[v] = relax;
-                    if (relax >= Bi) {
-                        D.insert(v); // Insert into FrontierManager directly if in [Bi, B).
-                    }
-                    else {
-                        K->addItem(v); // Otherwise, add to K to be batch-prepended later.
+        {
+            VertexArena::Frame batchFrame(vertexArena);
+            auto batch = vertexArena.newBuffer();
+            for (auto u : *Ui) {
+                for (auto [v, weight_uv] : constDegGraph.getNeighbors(u)) {
+                    if (relax(u, v, weight_uv, B)) {
+                        if (dhat[v] >= Bi) {
+                            batch.push_back(v); // Insert into FrontierManager if in [Bi, B), in one batch after the loop.
+                        }
+                        else {
+                            K->addItem(v); // Otherwise, add to K to be batch-prepended later.
+                        }
                     }
                 }
             }
+            // A vertex of the batch may have been relaxed below Bi afterwards, and moved to K; it is skipped.
+            D.insert(batch, Bi);
         }
         U->merge(*Ui); // Merge Ui into U.
 
@@ -57,7 +72,7 @@ BMSSP::BMSSPReturn BMSSP::BMSSP_recurse(Parameters lkt, Length B, ShpBlock S) {
         D.batchPrepend(std::move(K)); // Batch-prepend K to FrontierManager.
     }
 	auto WLessThanBprime = extractLessThanOrEqual(W, Bprime, true);
-    for (auto v : *WLessThanBprime) { U->addItem(v); }
+    for (auto v : WLessThanBprime) { U->addItem(v); }
 	DEBUG_BMSSP_LOG("BMSSP_recurse of parameter l=" << l << ", k=" << k << ", t=" << t << ", B=" << B << "completed with B'=" << Bprime << ", U=" << *U);
     return std::make_pair(Bprime, U);
 }
@@ -69,28 +84,31 @@ BMSSP::BMSSPReturn BMSSP::BMSSP_basecase(Parameters lkt, Length B, ShpBlock S) {
 
     assert(S->getSize() == 1 && "BMSSP base case requires a block with exactly one item.");
 
+    assert(k <= MAX_K && "The base case heap holds 2 * (k + 1) + 1 vertices only for k <= MAX_K.");
+    return BMSSP_basecase(smallBasecaseHeap, lkt, B, S);
+}
+
+
+template <typename Heap>
+BMSSP::BMSSPReturn BMSSP::BMSSP_basecase(Heap& H, Parameters lkt, Length B, ShpBlock S) {
+    auto [l, k, t] = lkt;
+
     // In base case, there is no need to use FrontierManager.
-    // A simple std::map suffices.
+    // A heap with decrease-key suffices.
     VertexIndex x = *S->begin();
-    ShpBlock U = std::make_shared<Block>(newList(), B, dhat[x], k);
-    std::map<Length, VertexIndex> H;
+    ShpBlock U = newBlock(newList(), B, dhat[x], k);
     U->addItem(x);
-    H[dhat[x]] = x;
+    H.pushOrDecrease(x, dhat[x]);
     while (!H.empty() && !U->overSized()) {
-        auto [_, u] = *H.begin();
-        H.erase(H.begin());
+        VertexIndex u = H.pop().vertex;
         U->addItem(u);
         for (const auto& [v, weight_uv] : constDegGraph.getNeighbors(u)) {
-            Length relax = dhat[u].relax(v, weight_uv);
-            if (relax <= dhat[v] && relax < B) {
-                if (auto it = H.find(dhat[v]); it != H.end()) {
-                    H.erase(it); // Remove the old value of dhat[v] if exists.
-                }
-                dhat[v] = relax; // Update dhat[v] with the new value.
-                H[dhat[v]] = v; // Insert the new value into H.
+            if (relax(u, v, weight_uv, B)) {
+                H.pushOrDecrease(v, dhat[v]); // Insert v into H, or decrease its key if it is already there.
             }
         }
     }
+    H.clear();
     if (U->getSize() <= k) {
         return std::make_pair(B, U); // Return B and U if the size is within limit.
     }
@@ -106,21 +124,22 @@ BMSSP::FindPivotReturn BMSSP::FindPivot(Parameters lkt, Length B, ShpBlock S) {
     auto [l, k, t] = lkt;
 	DEBUG_BMSSP_LOG("FindPivot called with parameters: l=" << l << ", k=" << k << ", t=" << t << ", B=" << B << ", S=" << *S);
     // Implementation of the FindPivot function as specified in the paper.
-    UList W = S->toUList();
+    VertexBuffer W = S->toBuffer(vertexArena);
     size_t W_count = 0;
     size_t kS = k * S->getSize();
-    std::vector<size_t> layerInW(constDegGraph.getNumOfVertices(), 0);
-    for (const auto& v : *W) { layerInW[v] = 1; }
+
+    // The workspace is reset in O(1), so this call costs O(|W|) rather than O(n).
+    findPivotState.reset();
+    for (auto v : W) { findPivotState.at(v).layerInW = 1; }
 
     for (size_t i = 1; i <= k; ++i) {
-        for (const auto& u : *W) {
-            if (layerInW[u] == i) {
+        for (auto u : W) { // W grows in the loop body, and the new vertices are visited as well.
+            if (findPivotState.get(u).layerInW == i) {
                 for (const auto& [v, weight_uv] : constDegGraph.getNeighbors(u)) {
-                    Length relax = dhat[u].relax(v, weight_uv);
-                    if (relax <= dhat[v] && relax < B) {
-                        dhat[v] = relax;
-                        if (layerInW[v] == 0) { ++W_count; W->emplace_back(v); }
-                        layerInW[v] = i + 1;
+                    if (relax(u, v, weight_uv, B)) {
+                        auto& state = findPivotState.at(v);
+                        if (state.layerInW == 0) { ++W_count; W.push_back(v); }
+                        state.layerInW = i + 1;
                     }
                 }
             }
@@ -128,23 +147,19 @@ BMSSP::FindPivotReturn BMSSP::FindPivot(Parameters lkt, Length B, ShpBlock S) {
         if (W_count > kS) {
 #ifdef DEBUG_BMSSP
 			DEBUG_BMSSP_LOG("FindPivot found too many vertices in layer " << i << ", returning S and W: ");
-            DEBUG_OS << "W vertex\t:";  for (auto& v : *W) { DEBUG_OS << std::setw(4) << v << ", "; } DEBUG_OS << std::endl;
-            DEBUG_OS << "Index   \t:";  for (size_t i = 0; i < constDegGraph.getNumOfVertices(); ++i) { DEBUG_OS << std::setw(4) << i; } DEBUG_OS << std::endl;
-            DEBUG_OS << "layerInW\t:";  for (size_t i = 0; i < layerInW.size(); ++i) { DEBUG_OS << std::setw(4) << layerInW[i]; } DEBUG_OS << std::endl;
+            DEBUG_OS << "W vertex\t:";  for (auto v : W) { DEBUG_OS << std::setw(4) << v << ", "; } DEBUG_OS << std::endl;
+            DEBUG_OS << "layerInW\t:";  for (auto v : W) { DEBUG_OS << std::setw(4) << findPivotState.get(v).layerInW << ", "; } DEBUG_OS << std::endl;
 #endif
-            return std::make_pair(S->toUList(), std::move(W));
+            recordFindPivotCall();
+            return std::make_pair(S->toBuffer(vertexArena), W);
         }
     }
 
-    UList P = std::make_unique<std::list<VertexIndex>>();
-
-    std::vector<size_t> subtree(constDegGraph.getNumOfVertices(), 0);
-    std::vector<bool> isRoot(constDegGraph.getNumOfVertices(), true);
 
     // Now DFS.
     std::stack<VertexIndex> dfsStack;
 
-    for (const auto& v : *W) { dfsStack.push(v); }
+    for (auto v : W) { dfsStack.push(v); }
 
     // For every vertex popped, its subtree size has been correctly calculated.
     // For every vertex, if its subtree size has not been calculated, it is kept zero.
@@ -157,15 +172,16 @@ BMSSP::FindPivotReturn BMSSP::FindPivot(Parameters lkt, Length B, ShpBlock S) {
 		auto stack_size = dfsStack.size();
         auto uPrev = dhat[u];
 #endif
-		if (subtree[u]) {dfsStack.pop(); continue;} // u has been processed, skip it.		
+		if (findPivotState.get(u).subtree) {dfsStack.pop(); continue;} // u has been processed, skip it.		
         size_t tmpTreeSize = 1; // Count itself.
         bool ready = true;
         for (const auto& [v, weight_uv] : constDegGraph.getNeighbors(u)) {
-            if (layerInW[v] && dhat[u].relax(v, weight_uv) <= dhat[v]) {
+            if (findPivotState.get(v).layerInW && dhat.noGreaterThan(dhat[u].relax(v, weight_uv), u, v)) {
                 // This is a valid edge in F.
-                isRoot[v] = false; // v is not a root.
-                if (subtree[v]) {
-                    tmpTreeSize += subtree[v];
+                auto& state = findPivotState.at(v);
+                state.isRoot = false; // v is not a root.
+                if (state.subtree) {
+                    tmpTreeSize += state.subtree;
                 }
                 else {
                     ready = false;
@@ -174,41 +190,45 @@ BMSSP::FindPivotReturn BMSSP::FindPivot(Parameters lkt, Length B, ShpBlock S) {
             }
         }
         if (ready) {
-            subtree[u] = tmpTreeSize;
+            findPivotState.at(u).subtree = tmpTreeSize;
             dfsStack.pop();
         }
     }
 
-    for (const auto& v : *W) {
-        if (isRoot[v] && subtree[v] >= k) {
-            P->emplace_back(v);
+    // P is allocated above W, which is complete by now.
+    VertexBuffer P = vertexArena.newBuffer();
+    for (auto v : W) {
+        const auto& state = findPivotState.get(v);
+        if (state.isRoot && state.subtree >= k) {
+            P.push_back(v);
         }
     }
 
 #ifdef DEBUG_BMSSP
-	DEBUG_BMSSP_LOG("FindPivot found " << P->size() << " pivot vertices with W of size " << W -> size());
-	DEBUG_OS << "Pivot vertex: ";  for (auto& v : *P) { DEBUG_OS << std::setw(4) << v << ", "; } DEBUG_OS << std::endl;
-    DEBUG_OS << "W vertex\t: ";  for (auto& v : *W) { DEBUG_OS << std::setw(4) << v << ", "; } DEBUG_OS << std::endl;
-    DEBUG_OS << "Index   \t:";  for (size_t i = 0; i < constDegGraph.getNumOfVertices(); ++i) { DEBUG_OS << std::setw(4) << i; } DEBUG_OS << std::endl;
-    DEBUG_OS << "layerInW\t:";  for (size_t i = 0; i < layerInW.size(); ++i) { DEBUG_OS << std::setw(4) << layerInW[i]; } DEBUG_OS << std::endl;
-    DEBUG_OS << "subtree \t:";  for (size_t i = 0; i < subtree.size(); ++i) { DEBUG_OS << std::setw(4) << subtree[i]; } DEBUG_OS << std::endl;
-    DEBUG_OS << "isRoot  \t:";  for (size_t i = 0; i < isRoot.size(); ++i) { DEBUG_OS << std::setw(4) << isRoot[i]; } DEBUG_OS << std::endl;
+	DEBUG_BMSSP_LOG("FindPivot found " << P.size() << " pivot vertices with W of size " << W.size());
+	DEBUG_OS << "Pivot vertex: ";  for (auto v : P) { DEBUG_OS << std::setw(4) << v << ", "; } DEBUG_OS << std::endl;
+    DEBUG_OS << "W vertex\t: ";  for (auto v : W) { DEBUG_OS << std::setw(4) << v << ", "; } DEBUG_OS << std::endl;
+    DEBUG_OS << "layerInW\t: ";  for (auto v : W) { DEBUG_OS << std::setw(4) << findPivotState.get(v).layerInW << ", "; } DEBUG_OS << std::endl;
+    DEBUG_OS << "subtree \t: ";  for (auto v : W) { DEBUG_OS << std::setw(4) << findPivotState.get(v).subtree << ", "; } DEBUG_OS << std::endl;
+    DEBUG_OS << "isRoot  \t: ";  for (auto v : W) { DEBUG_OS << std::setw(4) << findPivotState.get(v).isRoot << ", "; } DEBUG_OS << std::endl;
 #endif
 
+    recordFindPivotCall();
 
-    return std::make_pair(std::move(P), std::move(W));
+
+    return std::make_pair(P, W);
 }
 
 
-UList BMSSP::extractLessThanOrEqual(UList& uList, Length threshold, bool strict) {
-	DEBUG_BMSSP_LOG("Extracting vertices from uList with threshold " << threshold << " (strict: " << std::boolalpha << strict << ")");
-    // Implementation of the extraction logic from uList based on the threshold.
+VertexBuffer BMSSP::extractLessThanOrEqual(const VertexBuffer& vertices, Length threshold, bool strict) {
+	DEBUG_BMSSP_LOG("Extracting vertices from buffer with threshold " << threshold << " (strict: " << std::boolalpha << strict << ")");
+    // Implementation of the extraction logic from vertices based on the threshold.
     // If strict is true, it extracts vertices strictly less than the threshold;
     // otherwise, it extracts vertices less than or equal to the threshold.
-    UList result = std::make_unique<std::list<VertexIndex>>();
-    for (const auto& vertex : *uList) {
+    VertexBuffer result = vertexArena.newBuffer();
+    for (auto vertex : vertices) {
         if ((strict && dhat[vertex] < threshold) || (!strict && dhat[vertex] <= threshold)) {
-            result->push_back(vertex);
+            result.push_back(vertex);
         }
     }
     return result;
@@ -217,11 +237,7 @@ UList BMSSP::extractLessThanOrEqual(UList& uList, Length threshold, bool strict)
 
 void BMSSP::resetDhat() {
     // Reset the dhat array to its initial state.
-    dhat.clear();
-    dhat.emplace_back(Length::zero()); // Source vertex
-    for (VertexIndex v = 1; v < constDegGraph.getNumOfVertices(); ++v) {
-        dhat.emplace_back(std::numeric_limits<ActualLength>::infinity(), SIZE_MAX, NULL_VERTEX, v);
-    }
+    dhat.reset(constDegGraph.getNumOfVertices());
 }
 
 
@@ -233,8 +249,13 @@ void BMSSP::solve() {
     size_t l = static_cast<size_t>(std::ceil(std::cbrt(std::log2(n)))), k = l, t = l * l;
     DEBUG_BMSSP_LOG("Starting BMSSP algorithm on transformed graph with " << n << " vertices, with Parameters: l=" << l << ", k=" << k << ", t=" << t);
 
+    findPivotStats = {};
+    frontierHeaps.resize(l + 1); // Not resized during the recursion, which holds references into it.
+    frontierBuckets.resize(l + 1);
+    blockPool.resetPeak();
+
     // Start with the source vertex.
-    auto initialBlock = std::make_shared<Block>(newList(), Length::infinity(), Length::zero(), 0);
+    auto initialBlock = newBlock(newList(), Length::infinity(), Length::zero(), 0);
     initialBlock -> addItem(0);
 
 	DEBUG_BMSSP_LOG("Initial block created with source vertex 0; About to call top layer BMSSP_recurse.");
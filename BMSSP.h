@@ -2,25 +2,98 @@
 
 
 #include "GraphContext.h"
+#include "ConstDegView.h"
+#include "DistanceTable.h"
+#include "EpochArray.h"
+#include "IndexedHeap.h"
+#include "Selection.h"
 #include "Block.h"
 #include "ManualLinkedList.h"
+#include "KeyedList.h"
 #include "FrontierManager.h"
+#include "HeapFrontier.h"
+#include "RadixFrontier.h"
+
+#include <optional>
+
+
+// The per-vertex state of one FindPivot call, see algorithm 1 in the paper.
+struct FindPivotState {
+    size_t layerInW = 0; // 0 if the vertex is not in W, otherwise the (1-based) layer in which it was last relaxed.
+    size_t subtree = 0; // The size of its subtree in the forest F, 0 if not calculated yet.
+    bool isRoot = true; // Whether it is a root in the forest F.
+};
+
+
+// Counters of the vertices touched by FindPivot, accumulated over a solve().
+struct FindPivotStats {
+    size_t numOfCalls = 0;
+    size_t lastTouched = 0; // The number of vertices touched by the latest call, which is |W| of that call.
+    size_t maxTouched = 0;
+    size_t totalTouched = 0;
+};
 
 
 class BMSSP : public GraphContext {
 
-    std::vector<Length> dhat; // The \hat{d} array in the paper, storing the lengths of the shortest paths from the source to each vertex.
+    DistanceTable dhat; // The \hat{d} array in the paper, storing the lengths of the shortest paths from the source to each vertex.
+
+    std::shared_ptr<BlockListBase> spListBase; // The memory of the items of all Blocks, see BlockList.
+
+    // The memory of all Blocks, so that splits and pulls do not go to the global allocator.
+    // Declared after spListBase, so that it is destructed first, while the lists of the Blocks can still be recycled.
+    ObjectPool<Block> blockPool;
+
+	ConstDegView constDegGraph; // The constant-degree graph transformed from the original graph, computed on the fly.
+
+    // Scratch workspace of FindPivot, sized to the constant-degree graph once and reset in O(1) per call.
+    EpochArray<FindPivotState> findPivotState;
+    FindPivotStats findPivotStats;
 
-    std::shared_ptr<ManualLinkedListBase> spListBase;
+    // Backs the vertex buffers of FindPivot and BMSSP_recurse, released per recursion frame.
+    VertexArena vertexArena;
 
-	Graph constDegGraph; // The constant-degree graph transformed from the original graph.
+    // The selection algorithm used by Block and FrontierManager, see SelectionPolicy.
+    SelectionPolicy selectionPolicy = SelectionPolicy::StrictLinear;
+
+    // The buffers of every selection of Block and FrontierManager, reused across the whole solve.
+    SelectionScratch selectionScratch;
+
+    // The sorted keys of the batch being inserted into a FrontierManager, reused across the whole solve.
+    std::vector<Length> batchKeys;
+
+    // The Frontier backend of each recursion level, see FrontierPolicy.
+    FrontierPolicy frontierPolicy;
+
+    // The heaps of HeapFrontiers, one per recursion level, since only one frame of each level is alive at a time.
+    std::vector<std::vector<Length>> frontierHeaps;
+
+    // The buckets of RadixFrontiers, one set per recursion level likewise.
+    std::vector<RadixFrontier::Buckets> frontierBuckets;
+
+    // The priority queue of the base case, which holds at most 2 * (k + 1) + 1 vertices at once
+    // since it settles at most k + 1 vertices of out-degree at most 2.
+    // k = ceil(cbrt(log2 n)) <= MAX_K whenever n < 2^64, so the inline heap always suffices.
+    static constexpr size_t MAX_K = 4;
+    using SmallBasecaseHeap = InlineIndexedHeap<Length, 16>;
+    static_assert(2 * (MAX_K + 1) + 1 <= SmallBasecaseHeap::capacity(), "The base case heap must hold 2 * (k + 1) + 1 vertices");
+    SmallBasecaseHeap smallBasecaseHeap;
+
+    void recordFindPivotCall() {
+        size_t touched = findPivotState.getNumOfTouched();
+        ++ findPivotStats.numOfCalls;
+        findPivotStats.lastTouched = touched;
+        findPivotStats.maxTouched = std::max(findPivotStats.maxTouched, touched);
+        findPivotStats.totalTouched += touched;
+    }
 
     // The return value of BMSSP, used between recursive calls, as specified in algorithm 3 in the paper.
     // U and W may overlap, we need Block to rule out repetitions.
     using BMSSPReturn = std::pair<Length, ShpBlock>; // (B', U)
 
     // The return value of FindPivot, as specified in algorithm 1 in the paper.
-    using FindPivotReturn = std::pair<UList, UList>; // (P, W)
+    // Both live in vertexArena, within the frame of the calling BMSSP_recurse.
+    using FindPivotReturn = std::pair<VertexBuffer, VertexBuffer>; // (P, W)
 
     using Parameters = std::tuple<size_t, size_t, size_t>; // (l, k, t)
 
@@ -28,30 +101,89 @@ class BMSSP : public GraphContext {
     // the signature is specified as in algorithm 3 in the paper.
     BMSSPReturn BMSSP_recurse(Parameters lkt, Length B, ShpBlock S);
 
+    // Relaxes the arc (u, v) of length weight_uv under the bound B.
+    // If the Length of v through u is no greater than dhat[v] and less than B, it is committed to dhat[v] and true is returned.
+    bool relax(VertexIndex u, VertexIndex v, ActualLength weight_uv, const Length& B) {
+        Length relaxed = dhat[u].relax(v, weight_uv);
+        if (!dhat.noGreaterThan(relaxed, u, v) || !(relaxed < B)) { return false; }
+        spListBase->decreaseKey(v, relaxed); // The Block holding v, if any, caches its extremes and maybe a copy of dhat[v].
+        dhat.commit(u, v, relaxed);
+        return true;
+    }
+
     // base case for BMSSP, which is called when l = 0.
     // Implemented as algorithm 2 in the paper.
     BMSSPReturn BMSSP_basecase(Parameters lkt, Length B, ShpBlock S);
 
+    // The base case running on the given heap, which is empty on entry and cleared on exit.
+    template <typename Heap>
+    BMSSPReturn BMSSP_basecase(Heap& H, Parameters lkt, Length B, ShpBlock S);
+
     // FindPivot function, which is called in the BMSSP_recurse function.
     // The signature is specified as in algorithm 1 in the paper.
     FindPivotReturn FindPivot(Parameters lkt, Length B, ShpBlock S);
 
     // extracts the vertices from uList that are less than or equal to the threshold.
     // If strict is true, extract strictly less than; otherwise, extract less than or equal (defualt false).
-    UList extractLessThanOrEqual(UList& uList, Length threshold, bool strict = false);
+    // The result is a new buffer on top of vertexArena.
+    VertexBuffer extractLessThanOrEqual(const VertexBuffer& vertices, Length threshold, bool strict = false);
 
 public:
 
-    BMSSP(Graph&& g)
-        : GraphContext(std::move(g), "BMSSP"), constDegGraph(graph.transform2ConstDeg()) {
-        spListBase = std::make_shared<ManualLinkedListBase>(constDegGraph.getNumOfVertices());
-        dhat.reserve(constDegGraph.getNumOfVertices());
+    // The constant-degree graph is derived from g according to mode, see ConstDegView.
+    BMSSP(Graph&& g, ConstDegMode mode = ConstDegMode::Selective)
+        : GraphContext(std::move(g), "BMSSP"), constDegGraph(graph, mode), findPivotState(constDegGraph.getNumOfVertices()),
+          vertexArena(constDegGraph.getNumOfVertices()) {
+        if (constDegGraph.getNumOfVertices() > Length::MAX_VERTICES) {
+            throw std::overflow_error("BMSSP supports at most " + std::to_string(Length::MAX_VERTICES) + " vertices after the constant-degree transformation.");
+        }
+        resetDhat();
+        spListBase = std::make_shared<BlockListBase>(dhat); // The lists read keys from dhat, so it is reset first.
+    }
+
+    // Takes over a graph together with its precomputed constant-degree transformation,
+    // e.g. both graphs of a BinaryGraph loaded by loadBinaryGraph(), so that no transformation runs at startup.
+    // constDeg must be finalized and marked as constant-degree.
+    BMSSP(Graph&& g, Graph&& constDeg)
+        : GraphContext(std::move(g), "BMSSP"), constDegGraph(constDeg), findPivotState(constDegGraph.getNumOfVertices()),
+          vertexArena(constDegGraph.getNumOfVertices()) {
+        if (!constDeg.getIsConstDegree() || constDegGraph.getNumOfVertices() < graph.getNumOfVertices()) {
+            throw std::invalid_argument("BMSSP requires a constant-degree graph extending the original graph.");
+        }
+        if (constDegGraph.getNumOfVertices() > Length::MAX_VERTICES) {
+            throw std::overflow_error("BMSSP supports at most " + std::to_string(Length::MAX_VERTICES) + " vertices after the constant-degree transformation.");
+        }
         resetDhat();
+        spListBase = std::make_shared<BlockListBase>(dhat); // The lists read keys from dhat, so it is reset first.
     }
 
-    const std::vector<Length>& getDhat() const { return dhat; }
+    // The Length key of dhat[v], the only part of dhat needed for comparisons.
+    const Length& getKey(VertexIndex v) const { return dhat[v]; }
+
+    VertexIndex getPredecessor(VertexIndex v) const { return dhat.getPredecessor(v); }
+
+    SelectionPolicy getSelectionPolicy() const { return selectionPolicy; }
+
+    void setSelectionPolicy(SelectionPolicy policy) { selectionPolicy = policy; }
+
+    SelectionScratch& getSelectionScratch() { return selectionScratch; }
+
+    std::vector<Length>& getBatchKeys() { return batchKeys; }
+
+    const FrontierPolicy& getFrontierPolicy() const { return frontierPolicy; }
+
+    void setFrontierPolicy(FrontierPolicy policy) { frontierPolicy = std::move(policy); }
+
+    BlockList newList() { return spListBase->newList(); }
+
+    // Constructs a Block from args in blockPool.
+    template <typename... Args>
+    ShpBlock newBlock(Args&&... args) { return blockPool.make(std::forward<Args>(args)...); }
+
+    // The maximum number of Blocks alive at once during the latest solve.
+    size_t getPeakLiveBlocks() const { return blockPool.getPeakLive(); }
 
-    ManualLinkedList newList() { return spListBase->newList(); }
+    const FindPivotStats& getFindPivotStats() const { return findPivotStats; }
 
     void resetDhat();
 
@@ -0,0 +1,143 @@
+#include "BinaryGraph.h"
+
+#include <cstring>
+
+
+namespace {
+
+    uint64_t alignUp(uint64_t pos) {
+        return (pos + BINARY_GRAPH_ALIGNMENT - 1) / BINARY_GRAPH_ALIGNMENT * BINARY_GRAPH_ALIGNMENT;
+    }
+
+    void padTo(std::ofstream& fout, uint64_t pos) {
+        static const char zeros[BINARY_GRAPH_ALIGNMENT] = {};
+        auto curr = static_cast<uint64_t>(fout.tellp());
+        assert(curr <= pos && pos - curr < BINARY_GRAPH_ALIGNMENT);
+        fout.write(zeros, static_cast<std::streamsize>(pos - curr));
+    }
+
+    template <typename T>
+    void writeArray(std::ofstream& fout, uint64_t pos, std::span<const T> arr) {
+        padTo(fout, pos);
+        fout.write(reinterpret_cast<const char*>(arr.data()), static_cast<std::streamsize>(arr.size_bytes()));
+    }
+
+    // Writes the section of g starting at pos, and returns the position right after it.
+    uint64_t writeSection(std::ofstream& fout, uint64_t pos, const Graph& g) {
+        BinaryGraphSection section;
+        section.numOfVertices = g.getNumOfVertices();
+        section.numOfEdges = g.getNumOfEdges();
+        section.offsetsPos = alignUp(pos + sizeof(BinaryGraphSection));
+        section.targetsPos = alignUp(section.offsetsPos + g.getOffsets().size_bytes());
+        section.lengthsPos = alignUp(section.targetsPos + g.getTargets().size_bytes());
+
+        padTo(fout, pos);
+        fout.write(reinterpret_cast<const char*>(&section), sizeof(section));
+        writeArray(fout, section.offsetsPos, g.getOffsets());
+        writeArray(fout, section.targetsPos, g.getTargets());
+        writeArray(fout, section.lengthsPos, g.getLengths());
+        return section.lengthsPos + g.getLengths().size_bytes();
+    }
+
+    template <typename T>
+    std::span<const T> viewArray(const MappedFile& file, uint64_t pos, uint64_t count, const std::string& filename) {
+        if (pos % alignof(T) != 0 || pos > file.size() || count > (file.size() - pos) / sizeof(T)) {
+            throw std::runtime_error("Corrupted section in binary graph file: " + filename);
+        }
+        return { reinterpret_cast<const T*>(file.data() + pos), static_cast<size_t>(count) };
+    }
+
+    Graph viewSection(const std::shared_ptr<const MappedFile>& file, uint64_t pos, bool isConstDeg, const std::string& filename) {
+        if (pos > file->size() || file->size() - pos < sizeof(BinaryGraphSection)) {
+            throw std::runtime_error("Corrupted section in binary graph file: " + filename);
+        }
+        BinaryGraphSection section;
+        std::memcpy(&section, file->data() + pos, sizeof(section));
+        if (section.numOfVertices >= NULL_VERTEX) {
+            throw std::runtime_error("Too many vertices in binary graph file: " + filename);
+        }
+        if (section.numOfEdges > MAX_NUM_OF_EDGES) {
+            throw std::runtime_error("Too many edges in binary graph file: " + filename);
+        }
+        auto offsets = viewArray<EdgeIndex>(*file, section.offsetsPos, section.numOfVertices + 1, filename);
+        auto targets = viewArray<VertexIndex>(*file, section.targetsPos, section.numOfEdges, filename);
+        auto lengths = viewArray<ActualLength>(*file, section.lengthsPos, section.numOfEdges, filename);
+        return Graph(static_cast<VertexIndex>(section.numOfVertices), offsets, targets, lengths, file, isConstDeg);
+    }
+}
+
+
+BinaryGraph loadBinaryGraph(const std::string& filename) {
+    auto file = std::make_shared<const MappedFile>(filename);
+    if (file->size() < sizeof(BinaryGraphHeader)) {
+        throw std::runtime_error("Invalid file header: " + filename);
+    }
+    BinaryGraphHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, BINARY_GRAPH_MAGIC, sizeof(BINARY_GRAPH_MAGIC)) != 0) {
+        throw std::runtime_error("Invalid file header: " + filename);
+    }
+    if (header.version != BINARY_GRAPH_VERSION) {
+        throw std::runtime_error("Unsupported binary graph version " + std::to_string(header.version) + " in file: " + filename);
+    }
+    if (header.byteOrder != BINARY_GRAPH_BYTE_ORDER || header.vertexIndexBytes != sizeof(VertexIndex)
+        || header.edgeIndexBytes != sizeof(EdgeIndex) || header.lengthBytes != sizeof(ActualLength)
+        || bool(header.flags & BINARY_GRAPH_INTEGER_LENGTHS) != Weights::isInteger) {
+        throw std::runtime_error("Binary graph file was written with an incompatible layout: " + filename);
+    }
+
+    DEBUG_GRAPH_LOG("Mapping binary graph file: " << filename << " of " << file->size() << " bytes.");
+    BinaryGraph res{ viewSection(file, header.graphSection, header.flags & BINARY_GRAPH_IS_CONST_DEG, filename), std::nullopt };
+    if (header.flags & BINARY_GRAPH_HAS_CONST_DEG) {
+        if (((header.flags & BINARY_GRAPH_ALGEBRA_MASK) >> BINARY_GRAPH_ALGEBRA_SHIFT) != Algebra::id) {
+            throw std::runtime_error("Constant-degree section was written under another path algebra in file: " + filename);
+        }
+        res.constDegGraph.emplace(viewSection(file, header.constDegSection, true, filename));
+        if (res.constDegGraph->getNumOfVertices() < res.graph.getNumOfVertices()) {
+            throw std::runtime_error("Constant-degree section is smaller than the graph in file: " + filename);
+        }
+    }
+    return res;
+}
+
+
+void writeBinaryGraph(const std::string& filename, const Graph& g, bool withConstDeg, ConstDegMode mode) {
+    if (!g.isFinalized()) {
+        throw std::logic_error("Graph must be finalized before writeBinaryGraph.");
+    }
+    std::ofstream fout(filename, std::ios::binary | std::ios::trunc);
+    if (!fout) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+
+    BinaryGraphHeader header{};
+    std::memcpy(header.magic, BINARY_GRAPH_MAGIC, sizeof(BINARY_GRAPH_MAGIC));
+    header.version = BINARY_GRAPH_VERSION;
+    header.byteOrder = BINARY_GRAPH_BYTE_ORDER;
+    header.vertexIndexBytes = sizeof(VertexIndex);
+    header.edgeIndexBytes = sizeof(EdgeIndex);
+    header.lengthBytes = sizeof(ActualLength);
+    header.graphSection = alignUp(sizeof(BinaryGraphHeader));
+    if (g.getIsConstDegree()) { header.flags |= BINARY_GRAPH_IS_CONST_DEG; }
+    if (Weights::isInteger) { header.flags |= BINARY_GRAPH_INTEGER_LENGTHS; }
+    header.flags |= Algebra::id << BINARY_GRAPH_ALGEBRA_SHIFT;
+
+    // The header is rewritten at the end, once the position of the constant-degree section is known.
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    auto end = writeSection(fout, header.graphSection, g);
+    if (withConstDeg && !g.getIsConstDegree()) {
+        header.flags |= BINARY_GRAPH_HAS_CONST_DEG;
+        header.constDegSection = alignUp(end);
+        writeSection(fout, header.constDegSection, g.transform2ConstDeg(mode));
+    }
+    fout.seekp(0);
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!fout) {
+        throw std::runtime_error("Failed writing binary graph file: " + filename);
+    }
+}
+
+
+void convertText2Binary(const std::string& textFile, const std::string& binaryFile, bool withConstDeg, ConstDegMode mode) {
+    writeBinaryGraph(binaryFile, Graph(textFile), withConstDeg, mode);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+
+#include "Graph.h"
+#include "MappedFile.h"
+
+#include <optional>
+
+
+/**
+ * @brief The versioned binary on-disk format of a Graph, designed to be memory-mapped.
+ *
+ * Layout (all offsets in bytes from the start of the file, all sections aligned to BINARY_GRAPH_ALIGNMENT):
+ *  1. BinaryGraphHeader.
+ *  2. The section of the graph itself.
+ *  3. Optionally, the section of its constant-degree transformation (as by Graph::transform2ConstDeg(), in either mode).
+ * A section is a BinaryGraphSection record followed by the CSR arrays offsets[n + 1], targets[m], lengths[m],
+ * each starting at an aligned position.
+ *
+ * The arrays are stored in the native layout of VertexIndex, EdgeIndex and ActualLength,
+ * so that the loader can point a Graph into the mapping with no copying and no parsing.
+ * The header records the sizes, the byte order and the kind of lengths it was written with, and the loader rejects mismatching files.
+ */
+constexpr char BINARY_GRAPH_MAGIC[8] = { 'D', 'i', 'S', 'S', 'S', 'P', 'G', '\0' };
+constexpr uint32_t BINARY_GRAPH_VERSION = 1;
+constexpr uint32_t BINARY_GRAPH_BYTE_ORDER = 0x01020304;
+constexpr size_t BINARY_GRAPH_ALIGNMENT = 64;
+
+// Set in BinaryGraphHeader::flags if the file contains the constant-degree section.
+constexpr uint32_t BINARY_GRAPH_HAS_CONST_DEG = 1u << 0;
+// Set in BinaryGraphHeader::flags if the graph itself is already of constant degree.
+constexpr uint32_t BINARY_GRAPH_IS_CONST_DEG = 1u << 1;
+// Set in BinaryGraphHeader::flags if the lengths are integers rather than floating point numbers, see WeightTraits.
+constexpr uint32_t BINARY_GRAPH_INTEGER_LENGTHS = 1u << 2;
+// BinaryGraphHeader::flags holds Algebra::id at this shift, since the arcs of gadgets have the identity of the algebra.
+// The constant-degree section is only valid under the algebra it was written with.
+constexpr uint32_t BINARY_GRAPH_ALGEBRA_SHIFT = 3;
+constexpr uint32_t BINARY_GRAPH_ALGEBRA_MASK = 3u << BINARY_GRAPH_ALGEBRA_SHIFT;
+
+struct BinaryGraphHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t flags;
+    uint32_t vertexIndexBytes;
+    uint32_t edgeIndexBytes;
+    uint32_t lengthBytes;
+    uint64_t graphSection; // position of the section of the graph itself.
+    uint64_t constDegSection; // position of the constant-degree section, 0 if absent.
+};
+
+struct BinaryGraphSection {
+    uint64_t numOfVertices;
+    uint64_t numOfEdges;
+    uint64_t offsetsPos; // position of offsets[numOfVertices + 1].
+    uint64_t targetsPos; // position of targets[numOfEdges].
+    uint64_t lengthsPos; // position of lengths[numOfEdges].
+};
+
+
+// A graph loaded from a binary file, with its constant-degree transformation if the file carries one.
+// Both graphs share the same mapping, which stays alive as long as either of them does.
+struct BinaryGraph {
+    Graph graph;
+    std::optional<Graph> constDegGraph;
+};
+
+
+// Maps a binary graph file and builds Graph views on top of it.
+// Only the header and the section records are validated; the arrays are not scanned,
+// so that loading costs O(1) work and the pages are read in lazily by the solver.
+BinaryGraph loadBinaryGraph(const std::string& filename);
+
+// Writes g in the binary format.
+// If withConstDeg is set and g is not already of constant degree, its transformation by mode is stored as well.
+void writeBinaryGraph(const std::string& filename, const Graph& g, bool withConstDeg = true,
+    ConstDegMode mode = ConstDegMode::Selective);
+
+// Converts a graph from the text format read by Graph::Graph(const std::string&) into the binary format.
+void convertText2Binary(const std::string& textFile, const std::string& binaryFile, bool withConstDeg = true,
+    ConstDegMode mode = ConstDegMode::Selective);
@@ -1,5 +1,39 @@
 #include "Block.h"
 #include "BMSSP.h"
+#include "Selection.h"
+
+
+template <typename F>
+void Block::forEachKey([[maybe_unused]] const BMSSP& context, F&& f) const {
+#ifdef BLOCK_CONTIGUOUS_STORAGE
+    // Removing the current entry moves the last entry, which has been visited, into its place.
+    auto keys = items.getKeys();
+    for (size_t i = keys.size(); i-- > 0; ) {
+        Length key = keys[i];
+        f(key, key.getIndex());
+    }
+#else
+    for (auto it = items.begin(); it != items.end(); ) {
+        auto curr = *it;
+        ++ it;
+        f(context.getKey(curr), curr);
+    }
+#endif
+}
+
+
+const ListExtremes& Block::getExtremes(const BMSSP& context) const {
+    if (items.getExtremes().dirty) {
+        DEBUG_BLOCK_LOG("Rescanning extremes of " << *this);
+        Length minLength = Length::infinity(), maxLength = Length::zero();
+        forEachKey(context, [&](const Length& key, VertexIndex) {
+            minLength = std::min(minLength, key);
+            maxLength = std::max(maxLength, key);
+        });
+        items.setExtremes(minLength, maxLength);
+    }
+    return items.getExtremes();
+}
 
 
 void Block::addItem(VertexIndex v) {
@@ -11,16 +45,17 @@ void Block::addItem(VertexIndex v) {
 size_t Block::countNoGreater(const BMSSP& context, Length threshold) const {
 	DEBUG_BLOCK_LOG("Counting items no greater than " << threshold << " in " << *this);
     size_t count = 0;
-    for (auto it: items){
-        if (context.getDhat()[it] <= threshold) {
-            ++count;
-        }
-    }
+    forEachKey(context, [&](const Length& key, VertexIndex) { count += key <= threshold; });
     return count;
 }
 
 
-Length Block::locateMinQ(const BMSSP& context, size_t q) const {
+void Block::gatherKeys(const BMSSP& context, std::vector<Length>& keys) const {
+    forEachKey(context, [&](const Length& key, VertexIndex) { keys.push_back(key); });
+}
+
+
+Length Block::locateMinQ(BMSSP& context, size_t q) const {
 	DEBUG_BLOCK_LOG("Locating " << q << "-th smallest item in " << *this);
     if (q == 0 || q > items.size()) {
         throw std::out_of_range("k is out of range in locateMinK");
@@ -29,16 +64,42 @@ Length Block::locateMinQ(const BMSSP& context, size_t q) const {
     if (q == items.size()) { return max(context); }
     if (q == 1) { return min(context); }
 
+    return selectMinQ(context, q).pivot;
+}
+
+
+SelectionResult Block::selectMinQ(BMSSP& context, size_t q) const {
     // linked list is not convenient for random access,
-    // we reorganize them into a vector for easier processing.
-    std::vector<Length> cache;
-    cache.reserve(items.size());
-    for (auto it: items) { cache.emplace_back(context.getDhat()[it]); }
+    // we reorganize them into the selection scratch for easier processing.
+    auto& scratch = context.getSelectionScratch();
+    auto& cache = scratch.getKeys();
+    cache.clear();
+    gatherKeys(context, cache);
 
     // use linear time selection algorithm to find the k-th smallest item.
-    linearLocateMinQ<Length>(cache, q);
-    return cache[0];
-    //return linearLocateMinQ(cache, q);
+    return ::selectMinQ(cache, q, context.getSelectionPolicy(), scratch);
+}
+
+
+ShpBlock Block::extractSelected(BMSSP& context, const SelectionResult& result) {
+	DEBUG_BLOCK_LOG("Extracting " << result.split << " selected items no greater than " << result.pivot << " in " << *this);
+    const auto& cache = context.getSelectionScratch().getKeys();
+    assert(cache.size() == items.size() && result.split <= cache.size() && "extractSelected requires the latest selection to be of this Block");
+
+    auto newList = context.newList();
+    for (size_t i = 0; i < result.split; ++i) {
+        newList.add(cache[i].getIndex()); // As being added into newList, it will be removed from the current Block.
+    }
+    // The remaining keys are at hand, so the extremes of this Block need no rescan.
+    Length minLength = Length::infinity(), maxLength = Length::zero();
+    for (size_t i = result.split; i < cache.size(); ++i) {
+        minLength = std::min(minLength, cache[i]);
+        maxLength = std::max(maxLength, cache[i]);
+    }
+    items.setExtremes(minLength, maxLength);
+    auto old_lowerBound = lowerBound;
+    lowerBound = min(context);
+    return context.newBlock(std::move(newList), lowerBound, old_lowerBound, capacity);
 }
 
 
@@ -47,45 +108,38 @@ ShpBlock Block::extractLessThanOrEqual(BMSSP& context, Length threshold, bool st
 
     // If threshold >= upperBound, then we are extracting all items anyway, and this Block will become empty.
     if (threshold >= upperBound) {
-        auto newBlock = std::make_shared<Block>(*this);
+        auto newBlock = context.newBlock(*this);
         items = context.newList();
         return newBlock;
     }
     else if (threshold < lowerBound || (threshold == lowerBound && strict) ) {
-		return std::make_shared<Block>(context.newList(), threshold, threshold, capacity); // return an empty Block.
+		return context.newBlock(context.newList(), threshold, threshold, capacity); // return an empty Block.
     }
 
 
 	auto old_lowerBound = lowerBound;
 
+    // The extremes of the remaining items are collected in the same pass.
+    Length minLength = Length::infinity(), maxLength = Length::zero();
     auto newList = context.newList();
-    if (strict) {
-        lowerBound = threshold;
-        for (auto it = items.begin(); it != items.end(); ) {
-            auto curr = *it;
-            ++ it;
-            if (context.getDhat()[curr] < threshold) {
-                newList.add(curr); // As being added into newList, it will be removed from the current Block.
-            }
-        }
-    } else {
-        for (auto it = items.begin(); it != items.end(); ) {
-            auto curr = *it;
-            ++ it;
-            if (context.getDhat()[curr] <= threshold) {
-                newList.add(curr); // As being added into newList, it will be removed from the current Block.
-            }
+    forEachKey(context, [&](const Length& key, VertexIndex curr) {
+        if (strict ? key < threshold : key <= threshold) {
+            newList.add(curr); // As being added into newList, it will be removed from the current Block.
+        } else {
+            minLength = std::min(minLength, key);
+            maxLength = std::max(maxLength, key);
         }
-		lowerBound = min(context);
-    }
-    return std::make_shared<Block>(std::move(newList), lowerBound, old_lowerBound, capacity);
+    });
+    items.setExtremes(minLength, maxLength);
+    lowerBound = strict ? threshold : min(context);
+    return context.newBlock(std::move(newList), lowerBound, old_lowerBound, capacity);
 }
 
 
-UList Block::toUList() {
-	DEBUG_BLOCK_LOG("Converting to UList" << *this);
-    UList res = std::make_unique<std::list<VertexIndex>>();
-    for (auto it: items) { res->emplace_back(it); }
+VertexBuffer Block::toBuffer(VertexArena& arena) {
+	DEBUG_BLOCK_LOG("Converting to VertexBuffer" << *this);
+    VertexBuffer res = arena.newBuffer();
+    for (auto it: items) { res.push_back(it); }
     return res;
 }
 
@@ -96,33 +150,13 @@ void Block::merge(Block& other)  {
     lowerBound = std::min(lowerBound, other.lowerBound);
 }
 
-Length Block::min(const BMSSP& g) const {
-    Length minLength = upperBound;
-    for (auto v : items) {
-        minLength = std::min(minLength, g.getDhat()[v]);
-    }
-    return minLength;
-}
-
-
-Length Block::max(const BMSSP& g) const {
-    Length maxLength = lowerBound;
-    for (auto v : items) {
-        maxLength = std::max(maxLength, g.getDhat()[v]);
-    }
-    return maxLength;
-}
-
-
 void Block::removeUnsuit(const BMSSP& g) {
     DEBUG_BLOCK_LOG("Removing unsuited items from " << *this);
-    for (auto it = items.begin(); it != items.end(); ) {
-        auto curr = *it;
-        ++ it;
-        if (!suit(g.getDhat()[curr]) ) {
+    forEachKey(g, [&](const Length& key, VertexIndex curr) {
+        if (!suit(key)) {
             items.erase(curr);
         }
-    }
+    });
     DEBUG_BLOCK_LOG("After removing unsuited items, Block is now: " << *this);
 }
 
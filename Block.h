@@ -2,9 +2,24 @@
 
 #include "Length.h"
 #include "ManualLinkedList.h"
+#include "KeyedList.h"
+#include "VertexArena.h"
+#include "Selection.h"
+#include "ObjectPool.h"
 
 class Block;
-using ShpBlock = std::shared_ptr<Block>;
+using ShpBlock = PoolPtr<Block>; // Blocks live in the ObjectPool of BMSSP, see BMSSP::newBlock.
+
+// The storage of the items of Blocks.
+// By default, Blocks are linked lists of vertices, and every scan of a Block looks up dhat for each item.
+// Defining BLOCK_CONTIGUOUS_STORAGE makes them contiguous (key, vertex) lists instead, see KeyedList.
+#ifdef BLOCK_CONTIGUOUS_STORAGE
+using BlockList = KeyedList;
+using BlockListBase = KeyedListBase;
+#else
+using BlockList = ManualLinkedList;
+using BlockListBase = ManualLinkedListBase;
+#endif
 
 class BMSSP; // Forward declaration to avoid circular dependency.
 
@@ -22,14 +37,22 @@ class BMSSP; // Forward declaration to avoid circular dependency.
  */
 class Block {
 
-    ManualLinkedList items;
+    BlockList items;
     Length upperBound; // exclusive
     Length lowerBound; //inclusive
     size_t capacity; // designed max number of items in this Block, typically M. 
 
+    // Calls f(key, v) for every item v of this Block, where key is the Length of v.
+    // f may remove the current item from this Block, e.g. by adding it to another Block.
+    template <typename F>
+    void forEachKey(const BMSSP& context, F&& f) const;
+
+    // The extremes of the keys of the items, cached by the list and rescanned here only if dirty.
+    const ListExtremes& getExtremes(const BMSSP& context) const;
+
 public:
 
-    Block(ManualLinkedList&& its, Length upper = Length::infinity(), Length lower = Length::zero(), size_t cap = 0)
+    Block(BlockList&& its, Length upper = Length::infinity(), Length lower = Length::zero(), size_t cap = 0)
     : items(std::move(its)), upperBound(upper), lowerBound(lower), capacity(cap) {
         DEBUG_BLOCK_LOG("Constructing Block: " << *this);
         if (upperBound < lowerBound) { throw std::invalid_argument("Block lowerBound must be less than upperBound"); }
@@ -60,6 +83,9 @@ public:
 
     size_t countNoGreater(const BMSSP& context, Length threshold) const;
 
+    // Appends the Lengths of all items in this Block to keys.
+    void gatherKeys(const BMSSP& context, std::vector<Length>& keys) const;
+
     // Extracts all items in this Block that are less than or equal to the threshold to form a new Block.
     // The original Block is modified to remove these items.
     // If strict is true, then extract items < threshold. Else, extract items <= threshold.
@@ -69,21 +95,33 @@ public:
 
     // Extracts the smallest q items to form a new Block.
     // The original Block is modified to remove these items.
-    ShpBlock extractMinQ(BMSSP& context, size_t q) { return extractLessThanOrEqual(context, locateMinQ(context, q)); }
+    ShpBlock extractMinQ(BMSSP& context, size_t q) { return extractSelected(context, selectMinQ(context, q)); }
 
     // Find the q-th smallest item in this Block.
-    // This function runs in linear time.
-    Length locateMinQ(const BMSSP& context, size_t q) const;
+    // This function runs in linear time, with the selection policy of context.
+    Length locateMinQ(BMSSP& context, size_t q) const;
+
+    // Selects the q-th smallest item with the selection policy of context.
+    // The keys of this Block are gathered into the selection scratch of context,
+    // where they stay, rearranged around the result, until the next selection.
+    SelectionResult selectMinQ(BMSSP& context, size_t q) const;
+
+    // Moves the items of the first result.split keys of the latest selection, which must be of this Block, into a new Block.
+    // Like extractLessThanOrEqual(context, result.pivot), but it reads the keys from the selection scratch
+    // instead of walking the linked list again.
+    ShpBlock extractSelected(BMSSP& context, const SelectionResult& result);
 
     // Split this Block into two Blocks by median.
     // This block would hold the larger half, and the function returns the smaller half.
+    // The median is located with the selection policy of context.
     ShpBlock splitAtMedian(BMSSP& context) { return extractMinQ(context, items.size() / 2); }
 
-    UList toUList();
+    // Copies the items of this Block into a new buffer on top of arena.
+    VertexBuffer toBuffer(VertexArena& arena);
 
     // Merge another block into this block.
     // The other block will be empty after the merge.
-    // The complexity is linear to the size of the other linked list.
+    // The complexity is linear to the size of the other list, or of the smaller list with contiguous storage.
     void merge(Block& other);
 
     // allow iterating over items of this Block.
@@ -92,11 +130,13 @@ public:
 
     // Find the minimum Length in this Block.
     // If the Block is empty, return upperBound.
-    Length min(const BMSSP& g) const;
+    // The minimum is cached, so this is O(1) unless the minimal item has been removed since the last scan.
+    Length min(const BMSSP& g) const { return empty() ? upperBound : std::min(upperBound, getExtremes(g).min); }
 
     // Find the maximum Length in this Block.
     // If the Block is empty, return lowerBound.
-    Length max(const BMSSP& g) const;
+    // The maximum is cached, so this is O(1) unless the maximal item has been removed or decreased since the last scan.
+    Length max(const BMSSP& g) const { return empty() ? lowerBound : std::max(lowerBound, getExtremes(g).max); }
 
     bool empty() const { return items.empty(); }
 
@@ -113,4 +153,8 @@ public:
 	// extend the lower bound of this Block.
 	// effective only if newLowerBound < lowerBound.
     void extendLowerBound(Length newLowerBound);
+
+    // raise the lower bound of this Block, after the items below newLowerBound have been moved out.
+    // effective only if newLowerBound > lowerBound.
+    void raiseLowerBound(Length newLowerBound) { lowerBound = std::max(lowerBound, newLowerBound); }
 };
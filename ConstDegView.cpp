@@ -0,0 +1,102 @@
+#include "ConstDegView.h"
+
+#include <algorithm>
+
+
+ConstDegView::ConstDegView(const Graph& g, ConstDegMode transformMode)
+    : graph(g), numOfOriginalVertices(g.getNumOfVertices()), mode(transformMode), passThrough(g.getIsConstDegree()) {
+    if (!graph.isFinalized()) {
+        throw std::logic_error("Graph must be finalized before building a ConstDegView.");
+    }
+    if (passThrough) {
+        for (VertexIndex v = 0; v < graph.getNumOfVertices(); ++v) {
+            if (graph.getOutDegree(v) > 2) {
+                throw std::invalid_argument("Graph marked as constant-degree has a vertex of out-degree above 2.");
+            }
+        }
+        numOfVertices = numOfOriginalVertices;
+        return;
+    }
+
+    auto n = numOfOriginalVertices;
+    auto offsets = graph.getOffsets();
+    if (mode == ConstDegMode::Selective) {
+        // Vertex v of out-degree d > 2 gets d - 2 gadgets carrying its edges 1, ..., d - 2.
+        firstGadget.assign(n, NULL_VERTEX);
+        for (VertexIndex v = 0; v < n; ++v) {
+            if (offsets[v + 1] - offsets[v] <= 2) { continue; }
+            if (gadgetEdge.size() + (offsets[v + 1] - offsets[v] - 2) >= NULL_VERTEX - n) {
+                throw std::overflow_error("Too many edges to index the constant-degree transformation.");
+            }
+            firstGadget[v] = n + gadgetEdge.size();
+            for (auto e = offsets[v] + 1; e + 1 < offsets[v + 1]; ++e) { gadgetEdge.push_back(e); }
+        }
+        gadgetEdge.shrink_to_fit();
+        numOfVertices = n + gadgetEdge.size();
+        return;
+    }
+
+    auto m = graph.getNumOfEdges();
+    if (m > (NULL_VERTEX - n) / 2) {
+        throw std::overflow_error("Too many edges to index the constant-degree transformation.");
+    }
+    numOfVertices = n + 2 * m;
+
+    // Walk the edges in CSR order and append their gadgets to the cycles of both endpoints,
+    // in exactly the order transform2ConstDeg() has always used.
+    cycleNext.assign(numOfVertices, NULL_VERTEX);
+    std::vector<VertexIndex> curr(n);
+    for (VertexIndex v = 0; v < n; ++v) { curr[v] = v; }
+    auto targets = graph.getTargets();
+    VertexIndex tmp = n;
+    for (VertexIndex v = 0; v < n; ++v) {
+        for (auto e = offsets[v]; e < offsets[v + 1]; ++e) {
+            auto to = targets[e];
+            cycleNext[curr[v]] = tmp;
+            curr[v] = tmp;
+            cycleNext[curr[to]] = tmp + 1;
+            curr[to] = tmp + 1;
+            tmp += 2;
+        }
+    }
+    // Close the cycles.
+    for (VertexIndex v = 0; v < n; ++v) {
+        if (curr[v] != v) { cycleNext[curr[v]] = v; }
+    }
+}
+
+
+size_t ConstDegView::getNumOfEdges() const {
+    if (passThrough) { return graph.getNumOfEdges(); }
+    // Every edge stays an arc, and each gadget adds one zero-length arc into it.
+    if (mode == ConstDegMode::Selective) { return graph.getNumOfEdges() + gadgetEdge.size(); }
+    size_t res = graph.getNumOfEdges() * 3;
+    for (VertexIndex v = 0; v < numOfOriginalVertices; ++v) { res += (cycleNext[v] != NULL_VERTEX); }
+    return res;
+}
+
+
+VertexIndex ConstDegView::sourceOf(EdgeIndex e) const {
+    auto offsets = graph.getOffsets();
+    return static_cast<VertexIndex>(std::upper_bound(offsets.begin(), offsets.end(), e) - offsets.begin() - 1);
+}
+
+
+VertexIndex ConstDegView::getOriginalIndex(VertexIndex x) const {
+    if (passThrough || x < numOfOriginalVertices) { return x; }
+    auto j = x - numOfOriginalVertices;
+    if (mode == ConstDegMode::Selective) { return sourceOf(gadgetEdge[j]); }
+    // Out-gadgets lie on the cycle of the source, in-gadgets on the cycle of the target.
+    return (j & 1) ? graph.getTargets()[j >> 1] : sourceOf(j >> 1);
+}
+
+
+Graph ConstDegView::materialize() const {
+    if (passThrough) { return graph; }
+    Graph g(numOfVertices, true);
+    for (VertexIndex x = 0; x < numOfVertices; ++x) {
+        for (auto [to, length] : getNeighbors(x)) { g.addEdge(x, to, length); }
+    }
+    g.finalize();
+    return g;
+}
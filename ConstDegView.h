@@ -0,0 +1,128 @@
+#pragma once
+
+
+#include "Graph.h"
+
+
+/**
+ * @brief ConstDegArcs holds the at most 2 out-arcs of a vertex of a constant-degree graph by value.
+ */
+class ConstDegArcs {
+    Arc arcs[2];
+    unsigned count = 0;
+
+public:
+    void push(VertexIndex to, ActualLength length) {
+        assert(count < 2 && "A constant-degree vertex has at most 2 out-arcs");
+        arcs[count++] = { to, length };
+    }
+
+    const Arc* begin() const { return arcs; }
+    const Arc* end() const { return arcs + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Arc& operator[](size_t i) const { return arcs[i]; }
+};
+
+
+/**
+ * @brief ConstDegView presents the constant-degree transformation of a Graph without materializing it.
+ *
+ * With ConstDegMode::Full, the transformed graph is the one described at Graph::transform2ConstDeg():
+ * vertex v < n is kept, and edge e (its position in the CSR arrays) owns two gadget vertices,
+ * n + 2e on the zero-length cycle of its source and n + 2e + 1 on the zero-length cycle of its target.
+ * Vertex ids of gadgets, and the arc n + 2e -> n + 2e + 1 with the length of e, are derived arithmetically
+ * from the original CSR arrays. The only extra storage is the cycle successor of every transformed vertex,
+ * which takes n + 2m entries instead of the n + 2m offsets and n + 3m arcs of the materialized graph.
+ *
+ * With ConstDegMode::Selective, a vertex v of out-degree d <= 2 keeps its arcs as they are.
+ * If d > 2, v keeps its first arc and gets a zero-length arc to a chain of d - 2 gadget vertices;
+ * gadget i carries the arc of edge i + 1 of v, and the last gadget also carries the arc of the last edge.
+ * Only the out-degree needs to be bounded, so no cycle and no gadget on the target side is built.
+ * The chain is stored as the edge carried by each gadget, plus the first gadget of every vertex.
+ * On graphs where most vertices have out-degree <= 2 this adds few vertices, which shrinks every array
+ * the solver sizes by getNumOfVertices() and the parameters l, k, t it derives from it.
+ *
+ * If the graph is already of constant degree, the view passes its arcs through unchanged.
+ * In all modes the original vertices keep their indices, and getOriginalIndex() maps gadgets back.
+ * The view shares the CSR arrays of the graph, so it stays valid independently of the Graph it was built from.
+ */
+class ConstDegView {
+    Graph graph; // The original graph, sharing its CSR arrays.
+
+    VertexIndex numOfOriginalVertices;
+
+    VertexIndex numOfVertices; // Number of vertices of the transformed graph.
+
+    ConstDegMode mode;
+
+    bool passThrough;
+
+    // Full mode: cycleNext[x] is the next vertex after x on its zero-length cycle.
+    // NULL_VERTEX for original vertices without incident edges.
+    std::vector<VertexIndex> cycleNext;
+
+    // Selective mode: gadget n + j carries the arc of edge gadgetEdge[j].
+    // Gadgets of one vertex are consecutive, and so are the edges they carry.
+    std::vector<EdgeIndex> gadgetEdge;
+
+    // Selective mode: the first gadget of each vertex of out-degree above 2, NULL_VERTEX for the others.
+    std::vector<VertexIndex> firstGadget;
+
+    // The vertex whose out-arcs include edge e.
+    VertexIndex sourceOf(EdgeIndex e) const;
+
+public:
+
+    // The graph must be finalized.
+    explicit ConstDegView(const Graph& g, ConstDegMode transformMode = ConstDegMode::Full);
+
+    VertexIndex getNumOfVertices() const { return numOfVertices; }
+
+    VertexIndex getNumOfOriginalVertices() const { return numOfOriginalVertices; }
+
+    ConstDegMode getMode() const { return mode; }
+
+    size_t getNumOfEdges() const;
+
+    ConstDegArcs getNeighbors(VertexIndex x) const {
+        assert(x < numOfVertices && "Vertex index out of range in ConstDegView");
+        ConstDegArcs res;
+        if (passThrough) {
+            for (auto arc : graph.getNeighbors(x)) { res.push(arc.to, arc.length); }
+        } else if (mode == ConstDegMode::Selective) {
+            auto targets = graph.getTargets();
+            auto lengths = graph.getLengths();
+            if (x < numOfOriginalVertices) {
+                auto e = graph.getOffsets()[x];
+                if (firstGadget[x] == NULL_VERTEX) {
+                    for (; e < graph.getOffsets()[x + 1]; ++e) { res.push(targets[e], lengths[e]); }
+                } else {
+                    res.push(targets[e], lengths[e]);
+                    res.push(firstGadget[x], Algebra::identity());
+                }
+            } else {
+                auto j = x - numOfOriginalVertices;
+                auto e = gadgetEdge[j];
+                res.push(targets[e], lengths[e]);
+                // The chain goes on while the next gadget carries the next edge; otherwise e + 1 is the last edge.
+                if (j + 1 < gadgetEdge.size() && gadgetEdge[j + 1] == e + 1) { res.push(x + 1, Algebra::identity()); }
+                else { res.push(targets[e + 1], lengths[e + 1]); }
+            }
+        } else if (x < numOfOriginalVertices) {
+            if (cycleNext[x] != NULL_VERTEX) { res.push(cycleNext[x], Algebra::identity()); }
+        } else {
+            // The arc of the edge comes first, as in the materialized graph.
+            if (((x - numOfOriginalVertices) & 1) == 0) { res.push(x + 1, graph.getLengths()[(x - numOfOriginalVertices) >> 1]); }
+            res.push(cycleNext[x], Algebra::identity());
+        }
+        return res;
+    }
+
+    // Maps a vertex of the transformed graph to the original vertex whose cycle or chain it lies on.
+    // Every gadget is connected to that vertex by zero-length arcs.
+    VertexIndex getOriginalIndex(VertexIndex x) const;
+
+    // Builds the transformed graph explicitly, with the arcs of each vertex in the same order as getNeighbors().
+    Graph materialize() const;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+
+#include "Length.h"
+
+
+/**
+ * @brief DistanceTable is the \hat{d} array in the paper, stored as a structure of arrays.
+ * The Length keys, which every comparison needs, are contiguous in one array,
+ * while the predecessors live in a separate array touched only when a relaxation is committed.
+ * The hop count stays in the key since it takes part in the order, see Length.
+ * Predecessors are 32-bit like the indices in Length, which are below Length::MAX_VERTICES, so a vertex takes 20 bytes.
+ */
+class DistanceTable {
+    std::vector<Length> keys; // keys[v] is \hat{d}[v].
+    std::vector<uint32_t> preds; // preds[v] is the predecessor of v on the path of keys[v], NULL_PRED if none.
+
+    static constexpr uint32_t NULL_PRED = std::numeric_limits<uint32_t>::max();
+
+public:
+
+    // Sets the source 0 to zero and every other vertex to infinity.
+    void reset(size_t numOfVertices) {
+        keys.clear();
+        keys.reserve(numOfVertices);
+        keys.emplace_back(Length::zero()); // Source vertex
+        for (VertexIndex v = 1; v < numOfVertices; ++v) {
+            keys.emplace_back(Algebra::unreachable(), SIZE_MAX, v);
+        }
+        preds.assign(numOfVertices, NULL_PRED);
+        if (numOfVertices) { preds[0] = 0; } // The source is its own predecessor.
+    }
+
+    size_t size() const { return keys.size(); }
+
+    const Length& operator[](VertexIndex v) const { return keys[v]; }
+
+    std::span<const Length> getKeys() const { return keys; }
+
+    VertexIndex getPredecessor(VertexIndex v) const { return preds[v] == NULL_PRED ? NULL_VERTEX : preds[v]; }
+
+    // Whether relax, the Length of v through u, satisfies relax <= \hat{d}[v] in the order of the paper.
+    // Equal Lengths of v are broken by the predecessor, which Length does not hold.
+    bool noGreaterThan(const Length& relax, VertexIndex u, VertexIndex v) const {
+        return relax < keys[v] || (relax == keys[v] && u <= preds[v]);
+    }
+
+    // Records relax as the new \hat{d}[v], reached through u.
+    void commit(VertexIndex u, VertexIndex v, const Length& relax) {
+        keys[v] = relax;
+        assert(u < NULL_PRED && "DistanceTable only holds 32-bit predecessors");
+        preds[v] = static_cast<uint32_t>(u);
+    }
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+
+#include "types.h"
+
+#include <algorithm>
+
+
+/**
+ * @brief EpochArray is a fixed-size array whose entries can all be reset to a default value in O(1) time.
+ *
+ * Each entry carries the epoch in which it was last written. An entry whose stamp differs from the
+ * current epoch reads as the default value, so reset() only needs to advance the epoch.
+ * The stamps are cleared for real only when the epoch counter wraps around, once every 2^32 resets.
+ * It also counts the entries touched (written at least once) since the last reset.
+ */
+template <typename T>
+class EpochArray {
+    std::vector<T> values;
+    std::vector<uint32_t> stamps;
+    uint32_t epoch = 1;
+    size_t numOfTouched = 0;
+    T defaultValue;
+
+public:
+
+    explicit EpochArray(size_t n = 0, T def = T{}) : values(n, def), stamps(n, 0), defaultValue(def) {}
+
+    size_t size() const { return values.size(); }
+
+    // Resets every entry to the default value.
+    void reset() {
+        numOfTouched = 0;
+        if (++epoch == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            epoch = 1;
+        }
+    }
+
+    bool touched(size_t i) const { return stamps[i] == epoch; }
+
+    // Reads an entry, untouched entries read as the default value.
+    const T& get(size_t i) const { return touched(i) ? values[i] : defaultValue; }
+
+    // Returns a writable reference to an entry, initializing it to the default value if untouched.
+    T& at(size_t i) {
+        if (!touched(i)) {
+            stamps[i] = epoch;
+            values[i] = defaultValue;
+            ++ numOfTouched;
+        }
+        return values[i];
+    }
+
+    // The number of entries touched since the last reset.
+    size_t getNumOfTouched() const { return numOfTouched; }
+};
@@ -0,0 +1,190 @@
+#pragma once
+
+
+#include "types.h"
+
+#include <algorithm>
+#include <array>
+
+
+/**
+ * @brief FlatMap is an ordered map tailored to D1 of FrontierManager, a B+-tree of height two.
+ * Entries live in leaves of LEAF_SIZE sorted keys, with the keys of a leaf contiguous and apart from its values.
+ * The leaves are ordered by an array of their maximum keys, so that a lookup is two branchless binary searches
+ * over contiguous keys, instead of chasing the scattered nodes of a red-black tree.
+ *
+ * Besides lookup, it supports what D1 needs: inserting an entry (e.g. a half of a split Block) and popping the minimum.
+ * Leaves are recycled, so that neither allocates once the map has grown to its peak size.
+ * Inserting into a full leaf splits it, and updates the leaf array in O(size / LEAF_SIZE) time,
+ * which is one move of a few cache lines per LEAF_SIZE / 2 insertions.
+ * Popped leaves are left at the front of the leaf array, and trimmed once they are at least half of it.
+ */
+template <typename K, typename V, size_t LEAF_SIZE = 16>
+class FlatMap {
+    static_assert(LEAF_SIZE >= 2, "A leaf must hold two entries to be split");
+
+    struct Leaf {
+        size_t size = 0;
+        std::array<K, LEAF_SIZE> keys;
+        std::array<V, LEAF_SIZE> values;
+    };
+
+    std::vector<Leaf> leaves; // The storage of the leaves, in no particular order.
+    std::vector<uint32_t> freeLeaves; // Leaves recycled, to be reused before leaves grows.
+
+    // The leaves in order of their keys, from index first on; maxKeys[i] is the maximum key of leaf order[i].
+    std::vector<K> maxKeys;
+    std::vector<uint32_t> order;
+    size_t first = 0;
+
+    size_t numOfEntries = 0;
+
+    // The first index i in [0, n) with key < keys[i], or n if none, searched without branching on comparisons.
+    static size_t upperIndex(const K* keys, size_t n, const K& key) {
+        if (n == 0) { return 0; }
+        const K* base = keys;
+        while (n > 1) {
+            size_t half = n / 2;
+            base = (key < base[half]) ? base : base + half;
+            n -= half;
+        }
+        return (base - keys) + !(key < *base);
+    }
+
+    // The first index i in [0, n) with !(keys[i] < key), or n if none.
+    static size_t lowerIndex(const K* keys, size_t n, const K& key) {
+        if (n == 0) { return 0; }
+        const K* base = keys;
+        while (n > 1) {
+            size_t half = n / 2;
+            base = (base[half - 1] < key) ? base + half : base;
+            n -= half;
+        }
+        return (base - keys) + (*base < key);
+    }
+
+    uint32_t newLeaf() {
+        if (freeLeaves.empty()) {
+            leaves.emplace_back();
+            return static_cast<uint32_t>(leaves.size() - 1);
+        }
+        uint32_t id = freeLeaves.back();
+        freeLeaves.pop_back();
+        return id;
+    }
+
+    // Inserts key and value at position pos of leaf, which is not full.
+    static void insertAt(Leaf& leaf, size_t pos, const K& key, V value) {
+        for (size_t i = leaf.size; i > pos; --i) {
+            leaf.keys[i] = leaf.keys[i - 1];
+            leaf.values[i] = std::move(leaf.values[i - 1]);
+        }
+        leaf.keys[pos] = key;
+        leaf.values[pos] = std::move(value);
+        ++ leaf.size;
+    }
+
+    // Moves the upper half of the leaf at index i of order into a new leaf, right after it.
+    void split(size_t i) {
+        uint32_t id = newLeaf(); // may reallocate leaves, so the leaves are looked up after it.
+        Leaf& lower = leaves[order[i]];
+        Leaf& upper = leaves[id];
+        size_t keep = lower.size / 2;
+        for (size_t j = keep; j < lower.size; ++j) {
+            upper.keys[j - keep] = lower.keys[j];
+            upper.values[j - keep] = std::move(lower.values[j]);
+        }
+        upper.size = lower.size - keep;
+        lower.size = keep;
+        order.insert(order.begin() + i + 1, id);
+        maxKeys.insert(maxKeys.begin() + i + 1, maxKeys[i]);
+        maxKeys[i] = lower.keys[keep - 1];
+    }
+
+public:
+
+    bool empty() const { return numOfEntries == 0; }
+
+    size_t size() const { return numOfEntries; }
+
+    // The key and the value of the minimum entry. The map must be non-empty.
+    const K& frontKey() const { return leaves[order[first]].keys[0]; }
+    V& front() { return leaves[order[first]].values[0]; }
+
+    // Removes the minimum entry. The map must be non-empty.
+    void popFront() {
+        uint32_t id = order[first];
+        Leaf& leaf = leaves[id];
+        for (size_t i = 1; i < leaf.size; ++i) {
+            leaf.keys[i - 1] = leaf.keys[i];
+            leaf.values[i - 1] = std::move(leaf.values[i]);
+        }
+        leaf.values[-- leaf.size] = V{}; // releases the value.
+        -- numOfEntries;
+        if (leaf.size > 0) { return; }
+
+        freeLeaves.push_back(id);
+        if (++ first * 2 >= order.size()) {
+            order.erase(order.begin(), order.begin() + first);
+            maxKeys.erase(maxKeys.begin(), maxKeys.begin() + first);
+            first = 0;
+        }
+    }
+
+    // The value of the entry with the smallest key greater than key, nullptr if none.
+    V* upperBound(const K& key) {
+        size_t i = first + upperIndex(maxKeys.data() + first, maxKeys.size() - first, key);
+        if (i == order.size()) { return nullptr; }
+        Leaf& leaf = leaves[order[i]];
+        return &leaf.values[upperIndex(leaf.keys.data(), leaf.size, key)];
+    }
+
+    // Inserts the entry, or assigns value to the existing entry with the same key.
+    void insert(const K& key, V value) {
+        if (first == order.size()) {
+            order.assign(1, newLeaf());
+            maxKeys.assign(1, key);
+            first = 0;
+        }
+        // The first leaf whose maximum is no less than key, or the last leaf if key is the new maximum.
+        size_t i = std::min(first + lowerIndex(maxKeys.data() + first, maxKeys.size() - first, key), order.size() - 1);
+        {
+            Leaf& leaf = leaves[order[i]];
+            size_t pos = lowerIndex(leaf.keys.data(), leaf.size, key);
+            if (pos < leaf.size && !(key < leaf.keys[pos])) {
+                leaf.values[pos] = std::move(value);
+                return;
+            }
+        }
+        if (leaves[order[i]].size == LEAF_SIZE) {
+            split(i);
+            if (maxKeys[i] < key) { ++ i; }
+        }
+        Leaf& leaf = leaves[order[i]];
+        insertAt(leaf, lowerIndex(leaf.keys.data(), leaf.size, key), key, std::move(value));
+        maxKeys[i] = leaf.keys[leaf.size - 1];
+        ++ numOfEntries;
+    }
+
+    void clear() {
+        for (size_t i = first; i < order.size(); ++i) {
+            Leaf& leaf = leaves[order[i]];
+            for (size_t j = 0; j < leaf.size; ++j) { leaf.values[j] = V{}; }
+            leaf.size = 0;
+            freeLeaves.push_back(order[i]);
+        }
+        order.clear();
+        maxKeys.clear();
+        first = 0;
+        numOfEntries = 0;
+    }
+
+    // Calls f(key, value) on every entry in order of keys.
+    template <typename F>
+    void forEach(F&& f) const {
+        for (size_t i = first; i < order.size(); ++i) {
+            const Leaf& leaf = leaves[order[i]];
+            for (size_t j = 0; j < leaf.size; ++j) { f(leaf.keys[j], leaf.values[j]); }
+        }
+    }
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+
+#include "Block.h"
+
+
+/**
+ * @brief Frontier is the interface of the data structure D of BMSSP_recurse, specified in lemma 3.3 in the paper.
+ * It holds vertices of lengths in [currentLowerBound, upperBound), and supports Insert, Batch-prepend, and Pull.
+ *
+ * FrontierManager implements it as the lemma describes. The other backends give up the bounds of the lemma
+ * for smaller constants, which may pay off where M is small. FrontierPolicy picks the backend of each recursion level.
+ *
+ * Vertices may leave a frontier without being pulled, when they are relaxed and moved to another Block,
+ * so a backend must only pull vertices whose current lengths are still those they were inserted with.
+ */
+class Frontier {
+public:
+    virtual ~Frontier() = default;
+
+    // Insert a vertex. If its length is no less than upperBound, it is ignored.
+    // If the vertex is already in the frontier, it is moved according to its current length.
+    virtual void insert(VertexIndex v) = 0;
+
+    // Batch insert.
+    // Vertices whose lengths are not in [lowerBound, upperBound) are ignored, and repeated vertices are inserted once.
+    virtual void insert(const VertexBuffer& vertices, Length lowerBound = Length::zero()) = 0;
+
+    // Batch-prepend a block of vertices, all of them no greater than currentLowerBound.
+    virtual void batchPrepend(ShpBlock pBlock) = 0;
+
+    // Pull the smallest M vertices as a Block, or all of them if there are no more than M,
+    // together with the new currentLowerBound, which separates them from the rest (upperBound if nothing is left).
+    virtual std::pair<Length, ShpBlock> pull() = 0;
+
+    virtual Length getCurrentLowerBound() const = 0;
+};
+
+
+// The backends of Frontier.
+// Blocks: FrontierManager, the block-based structure of lemma 3.3.
+// BinaryHeap: HeapFrontier, a binary heap of keys with lazy deletion.
+// Radix: RadixFrontier, a radix heap of keys with lazy deletion, for integer weights.
+enum class FrontierKind { Blocks, BinaryHeap, Radix };
+
+inline const char* getFrontierKindName(FrontierKind kind) {
+    switch (kind) {
+    case FrontierKind::Blocks: return "Blocks";
+    case FrontierKind::BinaryHeap: return "BinaryHeap";
+    case FrontierKind::Radix: return "Radix";
+    }
+    return "Unknown";
+}
+
+
+/**
+ * @brief FrontierPolicy picks the Frontier backend of each recursion level of BMSSP_recurse.
+ * Level l uses the l-th kind given, and the levels beyond use the last one.
+ * Level 0 is the base case, which needs no frontier.
+ */
+class FrontierPolicy {
+    std::vector<FrontierKind> kindOfLevel;
+
+public:
+
+    // The same backend on all levels.
+    FrontierPolicy(FrontierKind kind = FrontierKind::Blocks) : kindOfLevel{ kind } {}
+
+    // kinds[l] on level l, and kinds.back() on deeper levels.
+    FrontierPolicy(std::vector<FrontierKind> kinds) : kindOfLevel(std::move(kinds)) {
+        if (kindOfLevel.empty()) { kindOfLevel.push_back(FrontierKind::Blocks); }
+    }
+
+    FrontierKind operator()(size_t level) const { return kindOfLevel[std::min(level, kindOfLevel.size() - 1)]; }
+};
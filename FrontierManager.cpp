@@ -1,12 +1,15 @@
 #include "FrontierManager.h"
 #include "BMSSP.h"
+#include "Selection.h"
+
+#include <algorithm>
 
 
 bool FrontierManager::clearEmptyPrefixD1() {
     sanityCheckD1();
     while (!D1.empty()) {
-        if (D1.begin()->second->empty()) {
-            D1.erase(D1.begin());
+        if (D1.front()->empty()) {
+            D1.popFront();
         } else {
             return true; // D1.front() is non-empty.
         }
@@ -17,10 +20,10 @@ bool FrontierManager::clearEmptyPrefixD1() {
 
 bool FrontierManager::clearEmptyPrefixD0() {
     while (!D0.empty()) {
-        if (D0.front()->empty()) {
-            D0.pop_front();
+        if (D0.back()->empty()) {
+            D0.pop_back();
         } else {
-            return true; // D0.front() is non-empty.
+            return true; // the front of D0 is non-empty.
         }
     }
     return false; // D0 is empty.
@@ -28,7 +31,7 @@ bool FrontierManager::clearEmptyPrefixD0() {
 
 void FrontierManager::insert(VertexIndex v){
     sanityCheckD1();
-    auto v_length = context.getDhat()[v];
+    auto v_length = context.getKey(v);
     DEBUG_FRONTIER_LOG("Inserting vertex " << v << " of length " << v_length << " into FrontierManager.");
 
     if (v_length >= upperBound) { return; } // Ignore items that exceed the upper bound.
@@ -40,23 +43,20 @@ void FrontierManager::insert(VertexIndex v){
         addDefaultBlock();
     }
 
-    if (v_length < D1.begin()->second->getLowerBound()) {
+    if (v_length < D1.front()->getLowerBound()) {
 		DEBUG_FRONTIER_LOG("Vertex " << v << " is smaller than D1's begin's lowerBound, extend it.");
-		D1.begin()->second->extendLowerBound(v_length);
+		D1.front()->extendLowerBound(v_length);
     }
 
     // Find the appropriate block in D1 to insert the item.
     // If the algorithm is correct, there should always be a suitable block.
-    auto it = D1.upper_bound(v_length);
-    if (it != D1.end() && it->second->suit(v_length)) {
-        it->second->addItem(v);
-		DEBUG_FRONTIER_LOG("Insert done. Inserted vertex " << v << " into " << * it -> second);
-        if (it->second->overSized()) {
-            // If the block is oversized, it will be split into two blocks.
-            auto newBlock = it->second->splitAtMedian(context);
-            D1[newBlock->getUpperBound()] = newBlock;
-            DEBUG_FRONTIER_LOG("Insert of " << v << "caused split at median: " << * it -> second << " and " << *newBlock);
-        }
+    ShpBlock* it = D1.upperBound(v_length);
+    if (it && (*it)->suit(v_length)) {
+        ShpBlock block = *it; // D1 may move its entries when the split half is inserted.
+        block->addItem(v);
+		DEBUG_FRONTIER_LOG("Insert done. Inserted vertex " << v << " into " << *block);
+        // If the block is oversized, it will be split into two blocks.
+        splitOversized(block);
     } else {
         throw std::logic_error("No suitable block found for the item in FrontierManager::insert.");
     }
@@ -64,6 +64,50 @@ void FrontierManager::insert(VertexIndex v){
 }
 
 
+void FrontierManager::insert(const VertexBuffer& vertices, Length lowerBound) {
+    sanityCheckD1();
+    auto& keys = context.getBatchKeys();
+    keys.clear();
+    for (auto v : vertices) {
+        const Length& key = context.getKey(v);
+        if (key >= lowerBound && key < upperBound) { keys.push_back(key); }
+    }
+    if (keys.empty()) { return; }
+    DEBUG_FRONTIER_LOG("Inserting a batch of " << keys.size() << " vertices into FrontierManager.");
+
+    // Keys of distinct vertices are distinct, so repeated vertices are adjacent after sorting.
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    currentLowerBound = std::min(currentLowerBound, keys.front());
+    if (D1.empty()) { addDefaultBlock(); }
+    if (keys.front() < D1.front()->getLowerBound()) { D1.front()->extendLowerBound(keys.front()); }
+
+    // Each run of keys below the upper bound of the block suiting its first key goes to that block.
+    for (size_t i = 0; i < keys.size(); ) {
+        ShpBlock* it = D1.upperBound(keys[i]);
+        if (!it || !(*it)->suit(keys[i])) {
+            throw std::logic_error("No suitable block found for the item in FrontierManager::insert.");
+        }
+        ShpBlock block = *it; // D1 may move its entries when the split parts are inserted.
+        for (; i < keys.size() && keys[i] < block->getUpperBound(); ++i) { block->addItem(keys[i].getIndex()); }
+        // The rest of the keys are no less than the upper bound of block, so splitting it does not affect their routes.
+        splitOversized(block);
+    }
+    sanityCheckD1();
+}
+
+
+void FrontierManager::splitOversized(const ShpBlock& block) {
+    while (block->overSized()) {
+        auto smallerHalf = block->splitAtMedian(context);
+        DEBUG_FRONTIER_LOG("Split at median: " << *block << " and " << *smallerHalf);
+        splitOversized(smallerHalf);
+        D1.insert(smallerHalf->getUpperBound(), smallerHalf);
+    }
+}
+
+
 void FrontierManager::batchPrepend(ShpBlock pBlock) {
     sanityCheckD1();
     DEBUG_FRONTIER_LOG("Batch-prepending " << *pBlock);
@@ -74,20 +118,59 @@ void FrontierManager::batchPrepend(ShpBlock pBlock) {
     if (pBlock -> empty()) { return; } // Ignore empty blocks.
 
     // If the block is oversized, it will be split into O(L/M) blocks of size <= M.
-    if (pBlock->overSized()) {
-        auto smallerHalf = pBlock->splitAtMedian(context);
-        batchPrepend(pBlock);
-        batchPrepend(smallerHalf);
-    } else {
-        currentLowerBound = std::min(currentLowerBound, pBlock->min(context));
-        D0.push_front(pBlock);
-        DEBUG_FRONTIER_LOG("Batch-prepending done. currentLowerBound: " << currentLowerBound);
+    currentLowerBound = std::min(currentLowerBound, pBlock->min(context));
+    prependToD0(pBlock);
+    DEBUG_FRONTIER_LOG("Batch-prepending done. currentLowerBound: " << currentLowerBound);
+}
+
+
+// Rearranges keys into groups of groupSize consecutive keys, every key of a group less than those of the next group.
+// The middle group boundary is selected first, then both sides are grouped recursively,
+// so that each level of the recursion takes linear time and there are O(log(n / groupSize)) levels.
+static void selectGroups(std::span<Length> keys, size_t groupSize, SelectionPolicy policy, SelectionScratch& scratch) {
+    size_t numOfGroups = (keys.size() + groupSize - 1) / groupSize;
+    if (numOfGroups <= 1) { return; }
+    size_t cut = numOfGroups / 2 * groupSize;
+    selectMinQ(keys, cut, policy, scratch);
+    selectGroups(keys.first(cut), groupSize, policy, scratch);
+    selectGroups(keys.subspan(cut), groupSize, policy, scratch);
+}
+
+
+void FrontierManager::prependToD0(const ShpBlock& block) {
+    if (!block->overSized()) {
+        D0.push_back(block);
+        return;
     }
+
+    auto& scratch = context.getSelectionScratch();
+    auto& keys = scratch.getKeys();
+    keys.clear();
+    block->gatherKeys(context, keys);
+    size_t capacity = block->getCapacity();
+    selectGroups(keys, capacity, context.getSelectionPolicy(), scratch);
+
+    // Each group becomes a block, bounded by the minimum of the next group, and the last one by the upper bound of block.
+    // The groups are pushed from the largest, so that the smallest one ends up at the front of D0.
+    size_t numOfGroups = (keys.size() + capacity - 1) / capacity;
+    size_t base = D0.size();
+    D0.resize(base + numOfGroups);
+    Length ub = block->getUpperBound();
+    for (size_t g = numOfGroups; g-- > 0; ) {
+        auto first = keys.begin() + g * capacity;
+        auto last = keys.begin() + std::min((g + 1) * capacity, keys.size());
+        Length lb = (g == 0 ? block->getLowerBound() : *std::min_element(first, last));
+        ShpBlock part = context.newBlock(context.newList(), ub, lb, capacity);
+        for (auto it = first; it != last; ++it) { part->addItem(it->getIndex()); }
+        D0[base + numOfGroups - 1 - g] = std::move(part);
+        ub = lb;
+    }
+    DEBUG_FRONTIER_LOG("Prepended " << numOfGroups << " blocks split from an oversized block to D0.");
 }
 
 
 ShpBlock FrontierManager::newBlock(Length ub, Length lb) {
-    return std::make_shared<Block>(context.newList(), ub, lb, M);
+    return context.newBlock(context.newList(), ub, lb, M);
 }
 
 // First, try to extract more than M or all items, S0 from D0 and S1 from D1,
@@ -125,24 +208,26 @@ std::pair<Length, ShpBlock> FrontierManager::pull() {
 
     ShpBlock S0 = newBlock(currentLowerBound, currentLowerBound);
     while (!D0.empty()) {
-        S0 -> merge(* D0.front());
-        D0.pop_front();
+        S0 -> merge(* D0.back());
+        D0.pop_back();
         if (S0 -> getSize() > M) { break; }
     }
 
     if (S0 -> getSize() >= M) {
-        Length S0Mth = S0 -> locateMinQ(context, M);
-        Length D1min = (clearEmptyPrefixD1() ? D1.begin()->second-> min(context) : upperBound);
+        auto S0Selected = S0 -> selectMinQ(context, M);
+        Length S0Mth = S0Selected.pivot;
+        Length D1min = (clearEmptyPrefixD1() ? D1.front() -> min(context) : upperBound);
         if (S0Mth < D1min) {
             // Case 1: output contains no vertex from D1, and extract no block from D1.
-            auto S0L = S0 -> extractLessThanOrEqual(context, S0Mth);
-            Length S0Gmin = S0 -> min(context);
+            // The selection has already put the M smallest keys first, so S0L is taken from it in the same pass.
+            auto S0L = S0 -> extractSelected(context, S0Selected);
+            Length S0Gmin = S0 -> getLowerBound(); // extractSelected raised it to the minimum of the rest.
             // Now S0 becomes S0G, and |S0L| == M.
             currentLowerBound = std::min(D1min, S0Gmin);
             if (!S0 -> empty()) {
                 // If S0 is non-empty, insert it back to D0.
                 // Note that now |S0| <= M.
-                D0.push_front(S0);
+                D0.push_back(S0);
             }
             sanityCheckD1();
 			DEBUG_FRONTIER_LOG("Pull- Case 1 all from D1: currentLowerBound updated to " << currentLowerBound << " and pulling " << *S0L);
@@ -153,8 +238,8 @@ std::pair<Length, ShpBlock> FrontierManager::pull() {
     // Case 2: output contains some vertex from D1, we can do O(1) extraction/insertion on D1.
     ShpBlock S1 = newBlock(currentLowerBound, currentLowerBound);
     while (!D1.empty()) {
-        S1 -> merge(* D1.begin() -> second);
-        D1.erase(D1.begin());
+        S1 -> merge(* D1.front());
+        D1.popFront();
         if (S1 -> getSize() > M) { break; }
     }
     sanityCheckD1();
@@ -172,18 +257,24 @@ std::pair<Length, ShpBlock> FrontierManager::pull() {
     // We are able to pull M items, so we can spend O(M) time.
     // Find the (M + 1)-th smallest item x in S0 and S1.
     // We cannot merge S0 and S1 because this may corrupt their linked list structure.
-    std::vector<Length> cache;
-    cache.reserve(S0 -> getSize() + S1 -> getSize());
-    for (auto it : *S0) { cache.emplace_back(context.getDhat()[it]); }
-    for (auto it : *S1) { cache.emplace_back(context.getDhat()[it]); }
-
-    linearLocateMinQ<Length>(cache, M + 1);
-    auto& x = cache[0];
-
-    auto S0L = S0 -> extractLessThanOrEqual(context, x, true);
-    auto S1L = S1 -> extractLessThanOrEqual(context, x, true);
-
-    // Now S0 becomes S0G and S1 becomes S1G, and |S0L| + |S1L| == M.
+    auto& scratch = context.getSelectionScratch();
+    auto& cache = scratch.getKeys();
+    cache.clear();
+    S0 -> gatherKeys(context, cache);
+    S1 -> gatherKeys(context, cache);
+
+    auto selected = selectMinQ(cache, M + 1, context.getSelectionPolicy(), scratch);
+    Length x = selected.pivot;
+    assert(selected.split == M + 1 && "Lengths of distinct vertices are distinct");
+
+    // The M smallest keys, which are less than x, come first in cache.
+    // Adding their vertices to L takes them out of S0 and S1, so no rescan of S0 and S1 is needed.
+    ShpBlock L = context.newBlock(context.newList(), x, std::min(S0 -> getLowerBound(), S1 -> getLowerBound()), S0 -> getCapacity());
+    for (size_t i = 0; i < M; ++i) { L -> addItem(cache[i].getIndex()); }
+    S0 -> raiseLowerBound(x);
+    S1 -> raiseLowerBound(x);
+
+    // Now S0 becomes S0G and S1 becomes S1G, and |L| == M.
     // S0G/S1G is empty if and only if D0/D1 is now empty.
     // And they cannot both be empty, so x is the new currentLowerBound.
     // Besides, |S0| and |S1| are bounded by 2M.
@@ -194,21 +285,17 @@ std::pair<Length, ShpBlock> FrontierManager::pull() {
     // In D0, we do not need to intentionally avoid under-sized blocks,
     // because we can extract them in O(1) time.
     // We only need to ensure not to insert an empty block.
-    if (S0 -> overSized()) {
-        auto smallerHalf = S0 -> splitAtMedian(context);
-        D0.push_front(S0);
-        D0.push_front(smallerHalf);
-    } else if (!S0 -> empty()) {
-        D0.push_front(S0);
+    if (!S0 -> empty()) {
+        prependToD0(S0);
     }
 
     // For S1, we need to ensure inserting it back does not increase under-sized blocks in D1.
     // If S1 is under-sized and D1 is non-empty, merge it to the first block in D1.
     // If this makes the first block in D1 oversized, let S1 take over the smaller half.
     if (S1 -> underSized() && !D1.empty()) {
-        D1.begin()->second->merge(*S1);
-        if (D1.begin()->second->overSized()) {
-            S1 = D1.begin()->second->splitAtMedian(context);
+        D1.front()->merge(*S1);
+        if (D1.front()->overSized()) {
+            S1 = D1.front()->splitAtMedian(context);
         }
     }
     sanityCheckD1();
@@ -219,29 +306,30 @@ std::pair<Length, ShpBlock> FrontierManager::pull() {
     // If S1 is normal-sized, we directly insert it into D1.
     if (S1 -> overSized()) {
         auto smallerHalf = S1 -> splitAtMedian(context);
-        D1[smallerHalf->getUpperBound()] = smallerHalf;
-        D1[S1->getUpperBound()] = S1;
+        D1.insert(smallerHalf->getUpperBound(), smallerHalf);
+        D1.insert(S1->getUpperBound(), S1);
         sanityCheckD1();
     } else if (!S1 -> empty()) {
-        D1[S1->getUpperBound()] = S1;
+        D1.insert(S1->getUpperBound(), S1);
         sanityCheckD1();
     }
 
     currentLowerBound = x;
-    S0L->merge(*S1L);
-	DEBUG_FRONTIER_LOG("Pull - Case 2 from both: currentLowerBound updated to " << currentLowerBound << " and pulling " << *S0L);
-    return std::make_pair(currentLowerBound, S0L);
+	DEBUG_FRONTIER_LOG("Pull - Case 2 from both: currentLowerBound updated to " << currentLowerBound << " and pulling " << *L);
+    return std::make_pair(currentLowerBound, L);
 }
 
 
 void FrontierManager::sanityCheckD1() {
 #ifdef DEBUG_FRONTIER
 	Length lastUpperBound = Length::infinity();
-    for (auto it = D1.begin(); it != D1.end(); ++it) {
-        if (it != D1.begin()) {
-			assert(it -> second -> getLowerBound() == lastUpperBound && "last block's upperBound does not match with this block's lowerBound");
+    bool isFirst = true;
+    D1.forEach([&](const Length&, const ShpBlock& block) {
+        if (!isFirst) {
+			assert(block -> getLowerBound() == lastUpperBound && "last block's upperBound does not match with this block's lowerBound");
         }
-        lastUpperBound = it->second->getUpperBound();
-    }
+        isFirst = false;
+        lastUpperBound = block->getUpperBound();
+    });
 #endif
 }
\ No newline at end of file
@@ -1,7 +1,8 @@
 #pragma once
 
 
-#include "Block.h"
+#include "Frontier.h"
+#include "FlatMap.h"
 
 
 class BMSSP; // Forward declaration to avoid circular dependency.
@@ -11,17 +12,17 @@ class BMSSP; // Forward declaration to avoid circular dependency.
  * @brief FrontierManager is the data structure mentioned in lemma 3.3 in the paper.
  * It maintians "frontier" vertices into Blocks and supports Insert, Batch-prepend, and Pull operations.
  * 
- * Its inner implementation is a linked list(D0) and a binary search tree(D1) of blocks.
+ * Its inner implementation is a stack(D0) and a flat B+-tree(D1) of blocks, see FlatMap.
  * D0 is block-wise monotone and receives input of batch-prepend.
  * D1 is block-wise sorted by their upper bounds as keys.
  * The intervals are disjoint and their union is the whole range of lengths of interest.
  */
-class FrontierManager {
+class FrontierManager : public Frontier {
 
     BMSSP& context; // The graph context that contains the graph and the dhat array.
 
-    std::forward_list<ShpBlock> D0;   // D_0 in the paper
-    std::map<Length, ShpBlock> D1; // D_1 in the paper
+    std::vector<ShpBlock> D0;   // D_0 in the paper, whose front is the back of the vector, since blocks only come and go there.
+    FlatMap<Length, ShpBlock> D1; // D_1 in the paper
     size_t M; // M in the paper, default capacity of the Blocks.
     Length upperBound; // B in the paper, upper bound for all inserted items.
     Length currentLowerBound; // B_i(B_i') in the paper, the latest lower bound of all items.
@@ -34,7 +35,7 @@ class FrontierManager {
 
     // Called when a vertex is to be inserted but D1 is empty.
     // Caller to check whether the above conditions are satisfied.
-    void addDefaultBlock() { D1[upperBound] = newBlock(upperBound); }
+    void addDefaultBlock() { D1.insert(upperBound, newBlock(upperBound)); }
 
     // Clear empty blocks in D1's prefix, until D1.front() is non-empty or D1 is empty.
     // If D1.front() is non-empty, return true.
@@ -44,6 +45,14 @@ class FrontierManager {
     // Similar to switchD1FrontNonEmpty(), but for D0.
     bool clearEmptyPrefixD0();
 
+    // Prepends a non-empty block to D0.
+    // If it is oversized, it is split into ceil(L/M) blocks of size <= M by one multiway selection, which takes O(L log(L/M)) time,
+    // and they are pushed in one go.
+    void prependToD0(const ShpBlock& block);
+
+    // Splits a block of D1 at medians until every part is within capacity, and inserts the split parts into D1.
+    void splitOversized(const ShpBlock& block);
+
     // merely used for debugging.
     void sanityCheckD1();
 
@@ -58,18 +67,21 @@ public:
     // If the vertex's length exceeds upperBound, it will be ignored.
     // If the block it is inserted into is oversized, it will be split into two blocks.
     // If it is currently in another block, it will first be removed from the old block, and then insert.
-    void insert(VertexIndex v);
+    void insert(VertexIndex v) override;
 
     // Batch insert.
-    void insert(UList vertices) { for (auto v : *vertices) { insert(v); } }
+    // Vertices whose lengths are not in [lowerBound, upperBound) are ignored, and repeated vertices are inserted once.
+    // The batch is sorted by length and routed to blocks of D1 run by run,
+    // so that D1 is searched and a block is split at most once per touched block, instead of once per vertex.
+    void insert(const VertexBuffer& vertices, Length lowerBound = Length::zero()) override;
 
     // Batch-prepend a block of vertices into D0.
     // Caller ensure pBlock->upperBound <= currentLowerBound. 
-    void batchPrepend(ShpBlock pBlock);
+    void batchPrepend(ShpBlock pBlock) override;
 
     ShpBlock newBlock(Length ub = Length::infinity(), Length lb = Length::zero());
 
-    Length getCurrentLowerBound() const { return currentLowerBound; }
+    Length getCurrentLowerBound() const override { return currentLowerBound; }
     
     // Pull smallest M vertices from D0 and D1 and currentLowerBound up to date.
     // If there are no more tham M vertices, all vertices are pulled.
@@ -77,5 +89,5 @@ public:
     // Because the size of the blocks may decrease outside FrontierManager,
     // Emptyness is only checked when trying to pull.
     // If both D0 and D1 are empty, will return an empty block.
-    std::pair<Length, ShpBlock> pull();
+    std::pair<Length, ShpBlock> pull() override;
 };
@@ -1,31 +1,266 @@
 #include "Graph.h"
+#include "ConstDegView.h"
 #include "Length.h"
+#include "MappedFile.h"
 
+#include <algorithm>
+#include <charconv>
+#include <thread>
 
-Graph::Graph(const std::string& filename, bool isConstDeg) : isConstDegree(isConstDeg) {
-    std::ifstream fin{ filename };
-    if (!fin) {
-        throw std::runtime_error("Cannot open file: " + filename);
+
+namespace {
+    // The storage that finalize() and the text loader build, and the spans of a Graph point into.
+    struct CSRStorage {
+        std::vector<EdgeIndex> offsets;
+        std::vector<VertexIndex> targets;
+        std::vector<ActualLength> lengths;
+    };
+
+
+    // Files smaller than this per thread are not worth splitting further.
+    constexpr size_t MIN_PARSE_CHUNK = size_t(1) << 20;
+
+    bool isLineBreak(char c) { return c == '\n' || c == '\r'; }
+
+    bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\v' || c == '\f' || isLineBreak(c); }
+
+    // Parses one whitespace-separated number starting at p, and advances p past it.
+    // Returns false if there is no more token or the token is not a valid number.
+    template <typename T>
+    bool parseToken(const char*& p, const char* end, T& value) {
+        while (p < end && isSpace(*p)) { ++p; }
+        if (p == end) { return false; }
+        auto [next, ec] = std::from_chars(p, end, value);
+        if (ec != std::errc{} || (next < end && !isSpace(*next))) { return false; }
+        p = next;
+        return true;
     }
-    if (!(fin >> numOfVertices >> numOfEdges)) {
+
+    // The result of parsing one line-aligned chunk of the edge list.
+    struct ParsedChunk {
+        std::vector<Edge> edges;
+        size_t firstOutOfRange = SIZE_MAX; // position in edges of the first edge with an invalid vertex index.
+        bool stoppedEarly = false; // whether parsing stopped at an invalid or incomplete triple.
+    };
+
+    void parseChunk(const char* p, const char* end, VertexIndex n, ParsedChunk& chunk) {
+        chunk.edges.reserve((end - p) / 16);
+        while (true) {
+            // Parsed at full width, so that indices beyond VertexIndex are reported as out of range.
+            uint64_t from, to;
+            ActualLength length;
+            if (!parseToken(p, end, from)) {
+                // Reaching the end exactly at a triple boundary is the normal way to finish.
+                while (p < end && isSpace(*p)) { ++p; }
+                chunk.stoppedEarly = (p != end);
+                return;
+            }
+            if (!parseToken(p, end, to) || !parseToken(p, end, length)) {
+                chunk.stoppedEarly = true;
+                return;
+            }
+            if ((from >= n || to >= n) && chunk.firstOutOfRange == SIZE_MAX) {
+                chunk.firstOutOfRange = chunk.edges.size();
+            }
+            chunk.edges.emplace_back(static_cast<VertexIndex>(from), static_cast<VertexIndex>(to), length);
+        }
+    }
+
+    // Runs fn(0), ..., fn(count - 1) on count threads and waits for all of them.
+    template <typename F>
+    void parallelFor(size_t count, F&& fn) {
+        if (count == 1) { fn(0); return; }
+        std::vector<std::thread> workers;
+        workers.reserve(count);
+        for (size_t i = 0; i < count; ++i) { workers.emplace_back(fn, i); }
+        for (auto& w : workers) { w.join(); }
+    }
+}
+
+
+// The text format is a header "n m" followed by m triples "from to length".
+// The body is split into line-aligned chunks which are parsed in parallel with std::from_chars.
+// The per-thread edge buffers are then merged into CSR by a parallel counting sort by source:
+// edges are first scattered into one bucket per vertex range, and each bucket is then sorted
+// by one thread on its own disjoint range of offsets. Both steps are stable, so the out-arcs
+// of each vertex keep the order of the file, exactly as with a sequential reader.
+// As with a sequential reader, only the first m edges are used and validated.
+// Splitting at line breaks assumes one edge per line; other layouts are parsed by a single thread.
+Graph::Graph(const std::string& filename, bool isConstDeg) : isConstDegree(isConstDeg) {
+    MappedFile file(filename);
+    const char* p = reinterpret_cast<const char*>(file.data());
+    const char* end = p + file.size();
+    uint64_t n;
+    if (!parseToken(p, end, n) || !parseToken(p, end, numOfEdges)) {
         throw std::runtime_error("Invalid file header: " + filename);
     }
-    adjacencyList.resize(numOfVertices);
-    for (size_t i = 0; i < numOfEdges; ++i) {
-        VertexIndex from, to;
-        ActualLength length;
-        if (!(fin >> from >> to >> length)) {
-            throw std::runtime_error("Not enough edge data in file: " + filename);
+    if (n >= NULL_VERTEX) {
+        throw std::overflow_error("Too many vertices for VertexIndex in file: " + filename);
+    }
+    if (numOfEdges > MAX_NUM_OF_EDGES) {
+        throw std::overflow_error("Too many edges for EdgeIndex in file: " + filename);
+    }
+    numOfVertices = static_cast<VertexIndex>(n);
+
+    // Split the body into chunks, each of them starting right after a line break.
+    size_t numOfThreads = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, size_t(end - p) / MIN_PARSE_CHUNK + 1);
+    std::vector<const char*> bounds{ p };
+    for (size_t i = 1; i < numOfThreads; ++i) {
+        const char* q = std::max(bounds.back(), p + size_t(end - p) / numOfThreads * i);
+        while (q < end && !isLineBreak(*q)) { ++q; }
+        while (q < end && isLineBreak(*q)) { ++q; }
+        bounds.push_back(q);
+    }
+    bounds.push_back(end);
+
+    std::vector<ParsedChunk> chunks(numOfThreads);
+    parallelFor(numOfThreads, [&](size_t t) { parseChunk(bounds[t], bounds[t + 1], numOfVertices, chunks[t]); });
+    for (size_t t = 0; t + 1 < numOfThreads; ++t) {
+        if (chunks[t].stoppedEarly) {
+            // Some triple spans a line break, or a token is malformed; fall back to one sequential chunk.
+            chunks.assign(1, ParsedChunk{});
+            parseChunk(bounds.front(), end, numOfVertices, chunks[0]);
+            numOfThreads = 1;
+            break;
         }
-        if (from >= numOfVertices || to >= numOfVertices) {
+    }
+
+    // Chunks are in file order, so edge i of chunk t is edge (first[t] + i) of the file.
+    // Only the first numOfEdges edges are kept; a chunk that stopped early ends the edge list.
+    std::vector<size_t> first(numOfThreads + 1, 0), kept(numOfThreads, 0);
+    size_t parsed = 0;
+    for (size_t t = 0; t < numOfThreads; ++t) {
+        first[t] = parsed;
+        kept[t] = std::min(chunks[t].edges.size(), numOfEdges - std::min(numOfEdges, parsed));
+        if (chunks[t].firstOutOfRange < kept[t]) {
             throw std::runtime_error("Vertex index out of range in file: " + filename);
         }
-        adjacencyList[from].emplace_back(to, length);
+        parsed += chunks[t].edges.size();
+        if (chunks[t].stoppedEarly) { break; }
+    }
+    if (parsed < numOfEdges) {
+        throw std::runtime_error("Not enough edge data in file: " + filename);
+    }
+
+    // Bucket b holds the edges whose source lies in [b * rangeSize, (b + 1) * rangeSize).
+    size_t numOfBuckets = numOfThreads;
+    VertexIndex rangeSize = numOfVertices / numOfBuckets + 1;
+    std::vector<std::vector<size_t>> bucketCount(numOfThreads, std::vector<size_t>(numOfBuckets + 1, 0));
+    parallelFor(numOfThreads, [&](size_t t) {
+        for (size_t i = 0; i < kept[t]; ++i) { ++ bucketCount[t][chunks[t].edges[i].from / rangeSize]; }
+    });
+    // Turn counts into the start position of (bucket b, thread t) in the bucketed array, ordered by b then t.
+    std::vector<size_t> bucketStart(numOfBuckets + 1, 0);
+    size_t pos = 0;
+    for (size_t b = 0; b < numOfBuckets; ++b) {
+        bucketStart[b] = pos;
+        for (size_t t = 0; t < numOfThreads; ++t) { std::swap(pos, bucketCount[t][b]); pos += bucketCount[t][b]; }
+    }
+    bucketStart[numOfBuckets] = pos;
+
+    std::vector<Edge> bucketed(numOfEdges);
+    parallelFor(numOfThreads, [&](size_t t) {
+        for (size_t i = 0; i < kept[t]; ++i) {
+            const auto& e = chunks[t].edges[i];
+            bucketed[bucketCount[t][e.from / rangeSize]++] = e;
+        }
+        std::vector<Edge>().swap(chunks[t].edges);
+    });
+
+    auto storage = std::make_shared<CSRStorage>();
+    storage->offsets.assign(numOfVertices + 1, 0);
+    storage->targets.resize(numOfEdges);
+    storage->lengths.resize(numOfEdges);
+    parallelFor(numOfBuckets, [&](size_t b) {
+        VertexIndex lo = std::min<VertexIndex>(b * rangeSize, numOfVertices);
+        VertexIndex hi = std::min<VertexIndex>(lo + rangeSize, numOfVertices);
+        if (lo == hi) { return; }
+        // Vertex ranges are disjoint, so each thread writes only offsets[lo, hi).
+        auto& off = storage->offsets;
+        std::vector<EdgeIndex> curr(hi - lo, 0);
+        for (size_t i = bucketStart[b]; i < bucketStart[b + 1]; ++i) { ++ curr[bucketed[i].from - lo]; }
+        EdgeIndex at = bucketStart[b];
+        for (VertexIndex v = lo; v < hi; ++v) {
+            off[v] = at;
+            at += curr[v - lo];
+            curr[v - lo] = off[v];
+        }
+        for (size_t i = bucketStart[b]; i < bucketStart[b + 1]; ++i) {
+            const auto& e = bucketed[i];
+            auto to = curr[e.from - lo]++;
+            storage->targets[to] = e.to;
+            storage->lengths[to] = e.length;
+        }
+    });
+    storage->offsets[numOfVertices] = numOfEdges;
+
+    offsets = storage->offsets;
+    targets = storage->targets;
+    lengths = storage->lengths;
+    csrOwner = std::move(storage);
+    finalized = true;
+    DEBUG_GRAPH_LOG("Constructing graph from file: " << filename << " with " << numOfThreads << " threads; Graph content: " << std::endl << *this);
+}
+
+void Graph::addEdge(VertexIndex from, VertexIndex to, ActualLength length) {
+    if (finalized) {
+        throw std::logic_error("Cannot add edges to a finalized Graph.");
+    }
+    if (from >= numOfVertices || to >= numOfVertices) {
+        throw std::out_of_range("Vertex index out of range in Graph::addEdge.");
     }
-    DEBUG_GRAPH_LOG("Constructing graph from file: " << filename << "; Graph content: " << std::endl << *this);
+    if (numOfEdges == MAX_NUM_OF_EDGES) {
+        throw std::overflow_error("Too many edges for EdgeIndex in Graph::addEdge.");
+    }
+    pendingEdges.emplace_back(from, to, length);
+    ++ numOfEdges;
 }
 
-Graph Graph::transform2ConstDeg() const{
+
+Graph::Graph(VertexIndex n, std::span<const EdgeIndex> csrOffsets, std::span<const VertexIndex> csrTargets,
+    std::span<const ActualLength> csrLengths, std::shared_ptr<const void> owner, bool isConstDeg)
+    : numOfVertices(n), numOfEdges(csrTargets.size()), offsets(csrOffsets), targets(csrTargets), lengths(csrLengths),
+    csrOwner(std::move(owner)), finalized(true), isConstDegree(isConstDeg) {
+    if (offsets.size() != n + 1 || lengths.size() != targets.size() || offsets.front() != 0 || offsets.back() != targets.size()) {
+        throw std::invalid_argument("Inconsistent CSR arrays for Graph.");
+    }
+}
+
+
+void Graph::finalize() {
+    if (finalized) { return; }
+    auto storage = std::make_shared<CSRStorage>();
+
+    // Counting sort by source. It is stable, so the out-arcs of each vertex keep their insertion order.
+    auto& off = storage->offsets;
+    off.assign(numOfVertices + 1, 0);
+    for (const auto& e : pendingEdges) { ++ off[e.from + 1]; }
+    for (VertexIndex v = 0; v < numOfVertices; ++v) { off[v + 1] += off[v]; }
+
+    storage->targets.resize(pendingEdges.size());
+    storage->lengths.resize(pendingEdges.size());
+    std::vector<EdgeIndex> curr(off.begin(), off.end() - 1);
+    for (const auto& e : pendingEdges) {
+        auto pos = curr[e.from]++;
+        storage->targets[pos] = e.to;
+        storage->lengths[pos] = e.length;
+    }
+
+    offsets = storage->offsets;
+    targets = storage->targets;
+    lengths = storage->lengths;
+    csrOwner = std::move(storage);
+
+    // Release the builder buffer, a plain clear() would keep its capacity.
+    std::vector<Edge>().swap(pendingEdges);
+    finalized = true;
+}
+
+
+Graph Graph::transform2ConstDeg(ConstDegMode mode) const{
+    if (!finalized) {
+        throw std::logic_error("Graph must be finalized before transform2ConstDeg.");
+    }
     if (isConstDegree) {
         DEBUG_GRAPH_LOG("Graph is already constant-degree, no need to transform.");
         return *this; // Already constant-degree graph.
@@ -33,37 +268,8 @@ Graph Graph::transform2ConstDeg() const{
     // For each vertex, we create a zero-length circle.
     // For each edge, we create two corresponding vertices in the new graph.
     // And we let the circle of the vertex include the corresponding vertices of its incident edges.
-
-    Graph g(getNumOfVertices() + getNumOfEdges() * 2, true);
-
-    std::vector<VertexIndex> head(getNumOfVertices());
-    std::vector<VertexIndex> curr(getNumOfVertices());
-
-    for (VertexIndex i = 0; i < getNumOfVertices(); ++i) {
-        head[i] = i;
-        curr[i] = i;
-    }
-    
-    VertexIndex tmp = getNumOfVertices();
-    for (VertexIndex v = 0; v < getNumOfVertices(); ++v) {
-        const auto& neighbors = getNeighbors(v);
-        for (Arc neighbor: neighbors) {
-            auto to = neighbor.to;
-            auto length = neighbor.length;
-            g.addEdge(curr[v], tmp, 0);
-            curr[v] = tmp;
-            g.addEdge(curr[to], tmp + 1, 0);
-            curr[to] = tmp + 1;
-            g.addEdge(tmp, tmp + 1, length);
-            tmp += 2;
-        }
-    }
-
-    for (VertexIndex i = 0; i < getNumOfVertices(); ++i) {
-        if (head[i] != curr[i]) {
-            g.addEdge(curr[i], head[i], 0);
-        }
-    }
+    // ConstDegView describes the transformed graph; here we only materialize it.
+    Graph g = ConstDegView(*this, mode).materialize();
     DEBUG_GRAPH_LOG("Transforming constant degree graph with content: " << std::endl << g);
     return g;
 }
@@ -93,7 +299,7 @@ void genRandGraph2File(const std::string& filename, VertexIndex n, size_t m,
     std::random_device rd;
     std::mt19937 gen(seed ? seed : rd());
     std::uniform_int_distribution<VertexIndex> vertex_dist(0, n - 1);
-    std::uniform_real_distribution<ActualLength> length_dist(minLen, maxLen);
+    Weights::Distribution length_dist(minLen, maxLen);
 
     std::set<std::pair<VertexIndex, VertexIndex>> edge_set;
     size_t count = 0;
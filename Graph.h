@@ -5,10 +5,63 @@
 
 
 /**
- * @brief Graph is represented in the way of adjacency lists.
+ * @brief ArcSpan is a read-only view over the out-arcs of one vertex in a CSR graph.
+ * Targets and lengths live in two separate arrays, so dereferencing an iterator yields an Arc by value.
+ */
+class ArcSpan {
+    std::span<const VertexIndex> targets;
+    std::span<const ActualLength> lengths;
+
+public:
+    constexpr ArcSpan() = default;
+
+    constexpr ArcSpan(std::span<const VertexIndex> t, std::span<const ActualLength> l) : targets(t), lengths(l) {
+        assert(targets.size() == lengths.size() && "ArcSpan requires matching targets and lengths");
+    }
+
+    class Iterator {
+        const VertexIndex* target;
+        const ActualLength* length;
+    public:
+        constexpr Iterator(const VertexIndex* t, const ActualLength* l) : target(t), length(l) {}
+        Arc operator*() const { return { *target, *length }; }
+        Iterator& operator++() { ++target; ++length; return *this; }
+        bool operator!=(const Iterator& other) const { return target != other.target; }
+    };
+
+    Iterator begin() const { return { targets.data(), lengths.data() }; }
+    Iterator end() const { return { targets.data() + targets.size(), lengths.data() + lengths.size() }; }
+
+    size_t size() const { return targets.size(); }
+    bool empty() const { return targets.empty(); }
+    Arc operator[](size_t i) const { return { targets[i], lengths[i] }; }
+};
+
+
+/**
+ * @brief The ways of transforming a graph into a graph of out-degree at most 2.
+ * Full: the transformation of the paper, every vertex gets a zero-length cycle through 2 gadget vertices per incident edge.
+ * Selective: vertices of out-degree at most 2 and their edges are kept as they are,
+ *            and only vertices of larger out-degree are split into a zero-length chain of gadget vertices.
+ * Both keep the original vertices at their indices, and only the out-degree matters to the algorithm.
+ */
+enum class ConstDegMode { Full, Selective };
+
+
+/**
+ * @brief Graph is represented in CSR (compressed sparse row) form.
  * Source is always indexed 0.
  * Graph only supports reading in data and basic preprocessing.
  * The algorithm is implemented in the GraphContext class.
+ *
+ * Edges are collected by addEdge() into a builder buffer, and finalize() turns them into
+ * three flat arrays (offsets, targets, lengths) with one counting sort by source.
+ * A Graph is finalized only once; after that it is read-only, and getNeighbors() is valid.
+ * The out-arcs of each vertex keep the order in which they were added.
+ *
+ * The CSR arrays are immutable once finalized, so they are held as spans over a shared owner:
+ * either the storage built by finalize(), or a memory-mapped binary file (see BinaryGraph.h).
+ * Copying a finalized Graph therefore shares its arrays instead of duplicating them.
  */
 class Graph {
 protected:
@@ -17,16 +70,33 @@ protected:
 
     size_t numOfEdges = 0; // The number of edges in the graph, which is $m$ in the paper.
 
-    std::vector<std::vector<Arc>> adjacencyList;
-    
+    // The out-arcs of v are at positions [offsets[v], offsets[v + 1]) of targets and lengths.
+    // offsets has numOfVertices + 1 entries once the graph is finalized.
+    std::span<const EdgeIndex> offsets;
+    std::span<const VertexIndex> targets;
+    std::span<const ActualLength> lengths;
+
+    // Keeps the memory behind the spans above alive.
+    std::shared_ptr<const void> csrOwner;
+
+    // Edges added before finalize(), in the order they were added.
+    std::vector<Edge> pendingEdges;
+
+    bool finalized = false;
+
     bool isConstDegree; // Whether the graph is a constant-degree graph.
 
 public:
 
-    Graph(VertexIndex n, bool isConstDeg = false) : numOfVertices(n), adjacencyList(n), isConstDegree(isConstDeg) {}
+    Graph(VertexIndex n, bool isConstDeg = false) : numOfVertices(n), isConstDegree(isConstDeg) {}
 
     Graph(const std::string& filename, bool isConstDeg = false);
 
+    // Builds a finalized Graph directly on top of existing CSR arrays without copying them.
+    // owner must keep the arrays alive; it is shared by all copies of this Graph.
+    Graph(VertexIndex n, std::span<const EdgeIndex> csrOffsets, std::span<const VertexIndex> csrTargets,
+        std::span<const ActualLength> csrLengths, std::shared_ptr<const void> owner, bool isConstDeg = false);
+
     Graph(Graph&&) = default;
     Graph& operator=(Graph&&) = default;
     Graph(const Graph&) = default;
@@ -36,13 +106,31 @@ public:
 
     size_t getNumOfEdges() const { return numOfEdges; }
 
-    const std::vector<Arc>& getNeighbors(VertexIndex v) const { return adjacencyList.at(v); }
+    bool isFinalized() const { return finalized; }
 
-    void addEdge(VertexIndex from, VertexIndex to, ActualLength length) {
-        adjacencyList.at(from).emplace_back(to, length);
-        ++ numOfEdges;
+    ArcSpan getNeighbors(VertexIndex v) const {
+        assert(finalized && v < numOfVertices && "getNeighbors requires a finalized graph and a valid vertex");
+        return { targets.subspan(offsets[v], offsets[v + 1] - offsets[v]),
+                 lengths.subspan(offsets[v], offsets[v + 1] - offsets[v]) };
     }
 
+    bool getIsConstDegree() const { return isConstDegree; }
+
+    // Raw CSR arrays, valid once finalized. Used by the binary graph writer.
+    std::span<const EdgeIndex> getOffsets() const { return offsets; }
+    std::span<const VertexIndex> getTargets() const { return targets; }
+    std::span<const ActualLength> getLengths() const { return lengths; }
+
+    size_t getOutDegree(VertexIndex v) const { return offsets[v + 1] - offsets[v]; }
+
+    // Feeds an edge into the builder buffer.
+    // Throws if the graph has already been finalized.
+    void addEdge(VertexIndex from, VertexIndex to, ActualLength length);
+
+    // Builds the CSR arrays from the edges added so far, and releases the builder buffer.
+    // Calling it on a finalized graph does nothing.
+    void finalize();
+
 	// Used merely for debugging.
     friend std::ostream& operator<<(std::ostream& os, const Graph& g);
 
@@ -50,7 +138,9 @@ public:
     // More precisely, each vertex has at most 2 outgoing edges (and at most 2 incoming edges, though we do not care about them).
 	// The indices in the old graph are preserved in the new graph.
 	// The new graph will have (n + 2 * m) vertices, and (n + 3 * m) edges, where n is the number of vertices in the old graph, and m is the number of edges in the old graph.
-    Graph transform2ConstDeg() const ;
+    // With ConstDegMode::Selective, only vertices of out-degree above 2 are expanded, see ConstDegView.
+    // This graph must be finalized, and the returned graph is finalized as well.
+    Graph transform2ConstDeg(ConstDegMode mode = ConstDegMode::Full) const ;
 
 };
 
@@ -0,0 +1,73 @@
+#include "HeapFrontier.h"
+#include "BMSSP.h"
+
+#include <algorithm>
+
+
+void HeapFrontier::push(const Length& key) {
+    heap.push_back(key);
+    std::push_heap(heap.begin(), heap.end(), std::greater<>{});
+}
+
+
+Length HeapFrontier::pop() {
+    std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+    Length key = heap.back();
+    heap.pop_back();
+    return key;
+}
+
+
+bool HeapFrontier::isStale(const Length& key) const {
+    return context.getKey(key.getIndex()) != key;
+}
+
+
+void HeapFrontier::insert(VertexIndex v) {
+    const Length& key = context.getKey(v);
+    if (key >= upperBound) { return; } // Ignore items that exceed the upper bound.
+    push(key);
+    currentLowerBound = std::min(currentLowerBound, key);
+}
+
+
+void HeapFrontier::insert(const VertexBuffer& vertices, Length lowerBound) {
+    for (auto v : vertices) {
+        const Length& key = context.getKey(v);
+        if (key < lowerBound || key >= upperBound) { continue; }
+        push(key);
+        currentLowerBound = std::min(currentLowerBound, key);
+    }
+}
+
+
+void HeapFrontier::batchPrepend(ShpBlock pBlock) {
+    DEBUG_FRONTIER_LOG("Batch-prepending " << *pBlock);
+    if (currentLowerBound < pBlock->max(context)) {
+        throw std::logic_error("pBlock max exceeds currentLowerBound in HeapFrontier::batchPrepend.");
+    }
+    if (pBlock -> empty()) { return; } // Ignore empty blocks.
+    currentLowerBound = std::min(currentLowerBound, pBlock->min(context));
+    for (auto v : *pBlock) { push(context.getKey(v)); }
+}
+
+
+std::pair<Length, ShpBlock> HeapFrontier::pull() {
+    DEBUG_FRONTIER_LOG("Pulling from HeapFrontier of capacity " << M << " with currentLowerBound = " << currentLowerBound);
+    auto list = context.newList();
+    Length last = Length::zero();
+    while (list.size() < M && !heap.empty()) {
+        Length key = pop();
+        if (isStale(key)) { continue; }
+        list.add(key.getIndex()); // A repeated entry of a pulled vertex adds nothing.
+        last = key;
+    }
+    // The repeats of the last pulled entry may still be on top.
+    while (!heap.empty() && (heap.front() == last || isStale(heap.front()))) { pop(); }
+
+    Length lowerBound = currentLowerBound;
+    currentLowerBound = heap.empty() ? upperBound : heap.front();
+    auto S = context.newBlock(std::move(list), currentLowerBound, lowerBound, M);
+    DEBUG_FRONTIER_LOG("Pull from HeapFrontier: currentLowerBound updated to " << currentLowerBound << " and pulling " << *S);
+    return std::make_pair(currentLowerBound, S);
+}
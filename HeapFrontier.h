@@ -0,0 +1,53 @@
+#pragma once
+
+
+#include "Frontier.h"
+
+
+class BMSSP; // Forward declaration to avoid circular dependency.
+
+
+/**
+ * @brief HeapFrontier is a Frontier on a binary heap of keys, without the blocks of FrontierManager.
+ * Insert and Batch-prepend push keys in O(log n) time each, and Pull pops the smallest M of them.
+ *
+ * Entries are never updated in place. Since a key carries its vertex, an entry is stale once its vertex has a different key,
+ * i.e. it has been relaxed and inserted again, or moved into another Block; stale entries are dropped when they reach the top.
+ * Repeated insertions of a vertex with the same key leave equal entries, which are popped one right after another.
+ *
+ * The heap lives in a buffer of BMSSP for the recursion level, so that it allocates nothing once the buffer has grown.
+ */
+class HeapFrontier : public Frontier {
+
+    BMSSP& context;
+    std::vector<Length>& heap; // A min-heap of keys.
+    size_t M;
+    Length upperBound;
+    Length currentLowerBound;
+
+    void push(const Length& key);
+
+    // Pops the top entry of the heap and returns it.
+    Length pop();
+
+    bool isStale(const Length& key) const;
+
+public:
+
+    // storage is cleared, and used as the heap during the lifetime of this frontier.
+    HeapFrontier(BMSSP& ctx, std::vector<Length>& storage, size_t m, Length ub)
+    : context(ctx), heap(storage), M(m), upperBound(ub), currentLowerBound(ub) {
+        DEBUG_FRONTIER_LOG("Constructing HeapFrontier with M = " << M << ", upperBound = " << upperBound);
+        heap.clear();
+    }
+
+    void insert(VertexIndex v) override;
+
+    void insert(const VertexBuffer& vertices, Length lowerBound = Length::zero()) override;
+
+    void batchPrepend(ShpBlock pBlock) override;
+
+    std::pair<Length, ShpBlock> pull() override;
+
+    Length getCurrentLowerBound() const override { return currentLowerBound; }
+};
@@ -0,0 +1,188 @@
+#pragma once
+
+
+#include "EpochArray.h"
+
+#include <array>
+
+
+// Helpers shared by the heaps below.
+namespace heap_detail {
+
+    template <typename Key>
+    struct Entry {
+        Key key;
+        VertexIndex vertex;
+    };
+
+    // Moves entries[i] up until the heap order is restored. moved(entry, pos) is called for every entry that moves.
+    template <size_t Arity, typename Key, typename Moved>
+    size_t siftUp(Entry<Key>* entries, size_t i, Moved&& moved) {
+        Entry<Key> e = entries[i];
+        while (i > 0) {
+            size_t parent = (i - 1) / Arity;
+            if (!(e.key < entries[parent].key)) { break; }
+            entries[i] = entries[parent];
+            moved(entries[i], i);
+            i = parent;
+        }
+        entries[i] = e;
+        moved(entries[i], i);
+        return i;
+    }
+
+    // Moves entries[i] down until the heap order is restored. moved(entry, pos) is called for every entry that moves.
+    template <size_t Arity, typename Key, typename Moved>
+    size_t siftDown(Entry<Key>* entries, size_t size, size_t i, Moved&& moved) {
+        Entry<Key> e = entries[i];
+        while (true) {
+            size_t first = i * Arity + 1;
+            if (first >= size) { break; }
+            size_t last = std::min(first + Arity, size);
+            size_t best = first;
+            for (size_t c = first + 1; c < last; ++c) {
+                if (entries[c].key < entries[best].key) { best = c; }
+            }
+            if (!(entries[best].key < e.key)) { break; }
+            entries[i] = entries[best];
+            moved(entries[i], i);
+            i = best;
+        }
+        entries[i] = e;
+        moved(entries[i], i);
+        return i;
+    }
+}
+
+
+/**
+ * @brief Indexed d-ary min-heaps of vertices keyed by Key, supporting decrease-key.
+ * They are the priority queues of BMSSP_basecase, which runs a Dijkstra bounded by k + 1 settled vertices.
+ *
+ * IndexedHeap keeps its entries in a preallocated vector and the position of every vertex in an EpochArray,
+ * so clear() is O(1) and no allocation happens once the heap has grown to its working size.
+ * InlineIndexedHeap keeps at most Capacity entries in an inline array and finds a vertex by a linear scan,
+ * which beats the position array for the handful of entries of a base case.
+ *
+ * Keys are compared with operator<. Ties are broken arbitrarily.
+ */
+template <typename Key, size_t Arity = 4>
+class IndexedHeap {
+    static_assert(Arity >= 2, "IndexedHeap requires an arity of at least 2");
+
+    using Entry = heap_detail::Entry<Key>;
+    static constexpr size_t NOT_IN_HEAP = std::numeric_limits<size_t>::max();
+
+    std::vector<Entry> entries;
+    EpochArray<size_t> position; // The position of each vertex in entries, NOT_IN_HEAP if absent.
+
+    auto tracker() { return [this](const Entry& e, size_t pos) { position.at(e.vertex) = pos; }; }
+
+public:
+
+    // Vertices are indexed from 0 to numOfVertices - 1; expectedSize entries are preallocated.
+    explicit IndexedHeap(size_t numOfVertices = 0, size_t expectedSize = 0) : position(numOfVertices, NOT_IN_HEAP) {
+        entries.reserve(expectedSize);
+    }
+
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+
+    bool contains(VertexIndex v) const { return position.get(v) != NOT_IN_HEAP; }
+
+    // Removes every entry in O(1).
+    void clear() {
+        entries.clear();
+        position.reset();
+    }
+
+    const Entry& top() const {
+        assert(!entries.empty() && "top() called on an empty heap");
+        return entries.front();
+    }
+
+    // Inserts v with key, or decreases its key if v is already in the heap.
+    // A key larger than the current one is ignored.
+    void pushOrDecrease(VertexIndex v, const Key& key) {
+        size_t pos = position.get(v);
+        if (pos == NOT_IN_HEAP) {
+            entries.push_back({ key, v });
+            heap_detail::siftUp<Arity>(entries.data(), entries.size() - 1, tracker());
+        }
+        else if (key < entries[pos].key) {
+            entries[pos].key = key;
+            heap_detail::siftUp<Arity>(entries.data(), pos, tracker());
+        }
+    }
+
+    // Removes and returns the entry of the minimum key.
+    Entry pop() {
+        Entry res = top();
+        position.at(res.vertex) = NOT_IN_HEAP;
+        Entry last = entries.back();
+        entries.pop_back();
+        if (!entries.empty()) {
+            entries.front() = last;
+            heap_detail::siftDown<Arity>(entries.data(), entries.size(), 0, tracker());
+        }
+        return res;
+    }
+};
+
+
+template <typename Key, size_t Capacity, size_t Arity = 4>
+class InlineIndexedHeap {
+    static_assert(Arity >= 2, "InlineIndexedHeap requires an arity of at least 2");
+
+    using Entry = heap_detail::Entry<Key>;
+
+    std::array<Entry, Capacity> entries;
+    size_t count = 0;
+
+    static constexpr auto untracked = [](const Entry&, size_t) {};
+
+    size_t find(VertexIndex v) const {
+        for (size_t i = 0; i < count; ++i) { if (entries[i].vertex == v) { return i; } }
+        return count;
+    }
+
+public:
+
+    static constexpr size_t capacity() { return Capacity; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    bool contains(VertexIndex v) const { return find(v) != count; }
+
+    void clear() { count = 0; }
+
+    const Entry& top() const {
+        assert(count && "top() called on an empty heap");
+        return entries[0];
+    }
+
+    // Inserts v with key, or decreases its key if v is already in the heap.
+    // A key larger than the current one is ignored.
+    // The caller guarantees that no more than Capacity vertices are in the heap at once.
+    void pushOrDecrease(VertexIndex v, const Key& key) {
+        size_t pos = find(v);
+        if (pos == count) {
+            assert(count < Capacity && "InlineIndexedHeap overflow");
+            entries[count++] = { key, v };
+            heap_detail::siftUp<Arity>(entries.data(), pos, untracked);
+        }
+        else if (key < entries[pos].key) {
+            entries[pos].key = key;
+            heap_detail::siftUp<Arity>(entries.data(), pos, untracked);
+        }
+    }
+
+    // Removes and returns the entry of the minimum key.
+    Entry pop() {
+        Entry res = top();
+        entries[0] = entries[--count];
+        if (count) { heap_detail::siftDown<Arity>(entries.data(), count, 0, untracked); }
+        return res;
+    }
+};
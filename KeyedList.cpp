@@ -0,0 +1,110 @@
+#include "KeyedList.h"
+
+
+void KeyedListBase::erase(VertexIndex v) {
+    auto [list, index] = location[v];
+    DEBUG_MLL_LOG("Erasing vertex " << v << " from its old KeyedList of id " << list);
+    auto& entries = lists[list];
+    extremes[list].remove(entries[index]);
+    // move the last entry into the hole.
+    entries[index] = entries.back();
+    location[entries[index].getIndex()].index = index;
+    entries.pop_back();
+    location[v] = Location{};
+}
+
+
+void KeyedListBase::recycleList(VertexIndex id) {
+    DEBUG_MLL_LOG("Recycling KeyedList with id " << id);
+    for (const auto& key : lists[id]) { location[key.getIndex()] = Location{}; }
+    lists[id].clear();
+    listPool.push_back(id);
+}
+
+
+KeyedList KeyedListBase::newList() {
+    VertexIndex newId;
+    if (listPool.empty()) {
+        // No recycled list available. Create a new one.
+        newId = lists.size();
+        lists.emplace_back();
+        extremes.emplace_back();
+    } else {
+        // There is a recycled list available. Reuse it.
+        newId = listPool.back();
+        listPool.pop_back();
+        extremes[newId] = ListExtremes{};
+    }
+    DEBUG_MLL_LOG("Creating a new KeyedList; newId: " << newId);
+    return KeyedList{*this, newId};
+}
+
+
+void KeyedListBase::debugPrint() const {
+#if defined(DEBUG_MLL) && !defined(DEBUG_MLL_COMPRESS_OUTPUT)
+    DEBUG_OS << "KeyedListBase state:" << std::endl;
+    for (VertexIndex id = 0; id < lists.size(); ++id) {
+        DEBUG_OS << "list " << id << ": \t";
+        for (const auto& key : lists[id]) { DEBUG_OS << key.getIndex() << " \t"; }
+        DEBUG_OS << std::endl;
+    }
+#endif // DEBUG
+}
+
+
+KeyedList::~KeyedList() {
+    if (!pListBase) {
+        DEBUG_MLL_LOG("Moved-from KeyedList object with id " << id << " is being destructed.");
+        return;
+    }
+    DEBUG_MLL_LOG("Real KeyedList object with id " << id << " is being destructed.");
+    base()->recycleList(id);
+}
+
+
+void KeyedList::add(VertexIndex v) {
+    DEBUG_MLL_LOG("Adding vertex " << v << " to KeyedList with id " << id);
+    auto pBase = base();
+    auto& location = pBase->location[v];
+    auto& entries = pBase->lists[id];
+
+    // The vertex is already in this list, no need to add it again.
+    if (location.list == id) { return; }
+
+    // If the vertex is in another list, remove it from the old list.
+    if (location.list != NULL_VERTEX) { pBase->erase(v); }
+
+    location = { id, static_cast<VertexIndex>(entries.size()) };
+    entries.push_back(pBase->dhat[v]);
+    pBase->extremes[id].add(pBase->dhat[v]);
+}
+
+
+void KeyedList::merge(KeyedList& other) {
+    DEBUG_MLL_LOG("Merging KeyedList of id " << other.id << " into KeyedList of id " << id);
+    auto pBase = base();
+    // Keep the larger list in place, so that only the entries of the smaller one are moved.
+    if (size() < other.size()) { std::swap(id, other.id); }
+    auto& entries = pBase->lists[id];
+    auto& otherEntries = pBase->lists[other.id];
+    for (const auto& key : otherEntries) {
+        pBase->location[key.getIndex()] = { id, static_cast<VertexIndex>(entries.size()) };
+        entries.push_back(key);
+    }
+    otherEntries.clear();
+    pBase->extremes[id].merge(pBase->extremes[other.id]);
+    pBase->extremes[other.id] = ListExtremes{};
+}
+
+
+void KeyedList::debugPrint() const {
+#ifdef DEBUG_MLL
+    #ifdef DEBUG_MLL_COMPRESS_OUTPUT
+		DEBUG_OS << "{"; for (auto it : *this) { DEBUG_OS << std::setw(3) << it << "->"; } DEBUG_OS << "}";
+    #else
+        DEBUG_OS << "KeyedList state for id " << id << ": size: " << size() << "; list: ";
+        for (const auto& key : getKeys()) { DEBUG_OS << std::setw(4) << key.getIndex() << " (" << key << ") "; }
+        DEBUG_OS << std::endl;
+    #endif
+#endif
+}
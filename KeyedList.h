@@ -0,0 +1,174 @@
+#pragma once
+
+
+#include "Length.h"
+#include "DistanceTable.h"
+#include "ListExtremes.h"
+
+#include <utility>
+
+
+class KeyedList;
+
+/**
+ * @brief KeyedListBase holds the memory of the keyed lists, the contiguous alternative to ManualLinkedListBase.
+ * Each list is a vector of keys, each a copy of dhat[vertex], which carries its vertex (see Length::getIndex()),
+ * so scanning the keys of a list is a linear read instead of a walk through next[] and a lookup of dhat per item.
+ *
+ * Like the linked lists, the lists are disjoint, and a vertex is removed by its value in O(1):
+ * the location array tells which list holds the vertex and where, and the last entry of that list fills the hole.
+ * The vectors of recycled lists keep their capacity, so the lists stop allocating once the pool is warm.
+ *
+ * The extremes of the keys of each list are cached as well, see ListExtremes.
+ *
+ * The copies must follow dhat: whoever decreases dhat[v] calls decreaseKey(v, newKey) right before.
+ */
+class KeyedListBase : public std::enable_shared_from_this<KeyedListBase> {
+    friend class KeyedList;
+
+    struct Location {
+        VertexIndex list = NULL_VERTEX; // the id of the list holding the vertex, NULL_VERTEX if none.
+        VertexIndex index = NULL_VERTEX; // the position of the vertex in that list.
+    };
+
+    const DistanceTable& dhat; // where the keys are copied from.
+
+    std::vector<std::vector<Length>> lists; // the keys of each list, indexed by list id.
+
+    std::vector<Location> location; // the location of each vertex.
+
+    std::vector<ListExtremes> extremes; // the extremes of the keys in each list, indexed by list id.
+
+    std::vector<VertexIndex> listPool; // the ids of recycled lists.
+
+    // Remove a vertex from its current list, by moving the last entry of that list into its place.
+    // caller responsible to check whether the vertex is in some list.
+    void erase(VertexIndex v);
+
+    // Recycle a list, keeping the capacity of its vector.
+    // This is called when a KeyedList is destructed.
+    void recycleList(VertexIndex id);
+
+public:
+    KeyedListBase(const DistanceTable& dhat) : dhat(dhat), location(dhat.size()) {
+        DEBUG_MLL_LOG("Constructing KeyedListBase of size: " << dhat.size());
+    }
+
+    // Create a new list.
+    KeyedList newList();
+
+    // Must be called right before dhat[v] decreases to newKey, to keep the entry of v and the extremes of its list.
+    void decreaseKey(VertexIndex v, const Length& newKey) {
+        auto [list, index] = location[v];
+        if (list == NULL_VERTEX) { return; }
+        extremes[list].decrease(dhat[v], newKey);
+        lists[list][index] = newKey;
+    }
+
+    void debugPrint() const;
+};
+
+/**
+ * @brief KeyedList is a list of vertices kept as copies of their keys, with the same interface as ManualLinkedList.
+ * It does not own the memory, so it can be copied and moved at a low cost.
+ * The order of the entries is not preserved by removals.
+ * Like ManualLinkedList, it reaches the base through a plain pointer, checked by a weak_ptr with DEBUG_MLL_LIFETIME.
+ */
+class KeyedList {
+    friend class KeyedListBase;
+    KeyedListBase* pListBase; // nullptr once moved from.
+#ifdef DEBUG_MLL_LIFETIME
+    std::weak_ptr<KeyedListBase> wpListBase;
+#endif
+    VertexIndex id;
+
+    KeyedListBase* base() const {
+#ifdef DEBUG_MLL_LIFETIME
+        assert(!wpListBase.expired() && "KeyedList is used after its KeyedListBase is destructed");
+#endif
+        return pListBase;
+    }
+
+    // KeyedList should only be created by KeyedListBase::newList().
+    KeyedList(KeyedListBase& base, VertexIndex id)
+        : pListBase(&base),
+#ifdef DEBUG_MLL_LIFETIME
+          wpListBase(base.weak_from_this()),
+#endif
+          id(id) {
+        DEBUG_MLL_LOG("Constructing KeyedList of id: " << id);
+    }
+
+    std::vector<Length>& entries() const { return base()->lists[id]; }
+
+public:
+
+    // KeyedList is so small that copying it is cheap.
+    // A moved-from list no longer refers to its entries, so that only the new owner recycles them.
+    KeyedList(KeyedList&& other) noexcept
+        : pListBase(std::exchange(other.pListBase, nullptr)),
+#ifdef DEBUG_MLL_LIFETIME
+          wpListBase(std::move(other.wpListBase)),
+#endif
+          id(other.id) {}
+    KeyedList& operator=(KeyedList&& other) noexcept {
+        pListBase = std::exchange(other.pListBase, nullptr);
+#ifdef DEBUG_MLL_LIFETIME
+        wpListBase = std::move(other.wpListBase);
+#endif
+        id = other.id;
+        return *this;
+    }
+    KeyedList(const KeyedList& other) = default;
+    KeyedList& operator=(const KeyedList& other) = default;
+
+    ~KeyedList();
+
+    // Iterates the vertices from the last entry to the first.
+    // Removing the current vertex, or any vertex of this list, only moves an entry that has been visited,
+    // so no vertex still to be visited is skipped; the entry moved into a hole below may be visited twice.
+    class Iterator {
+        const KeyedList& list;
+        size_t remaining; // the entries [0, remaining) are yet to be visited.
+    public:
+        Iterator(const KeyedList& lst, size_t start) : list(lst), remaining(start) {}
+        VertexIndex operator*() const { return list.entries()[remaining - 1].getIndex(); }
+        Iterator& operator++() { remaining = std::min(remaining - 1, list.size()); return *this; }
+        bool operator!=(const Iterator& other) const { return remaining != other.remaining; }
+    };
+
+    VertexIndex getId() const { return id; }
+
+    bool empty() const { return entries().empty(); }
+
+    Iterator begin() const { return Iterator{*this, size()}; }
+
+    Iterator end() const { return Iterator{*this, 0}; }
+
+    size_t size() const { return entries().size(); }
+
+    // The cached extremes of the keys in this list, which must be rescanned if dirty.
+    const ListExtremes& getExtremes() const { return base()->extremes[id]; }
+
+    // Stores the rescanned extremes of the keys in this list.
+    void setExtremes(const Length& min, const Length& max) const { base()->extremes[id] = { min, max, false }; }
+
+    // The keys of this list, valid until the next addition to it.
+    std::span<const Length> getKeys() const { return entries(); }
+
+    // Add a vertex to this list, with a copy of its current key.
+    // If the vertex is already in another list, it will be removed from the old list.
+    // If the vertex is already in this list, it will be ignored.
+    void add(VertexIndex v);
+
+    // Remove a vertex from this list.
+    // caller responsible to check whether the vertex is in this list.
+    void erase(VertexIndex v) { base()->erase(v); }
+
+    // Merge another list into this list.
+    // The other list will be empty after the merge.
+    // The entries of the smaller list are moved, so the complexity is linear to the smaller size.
+    void merge(KeyedList& other);
+
+    void debugPrint() const;
+};
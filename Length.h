@@ -6,69 +6,104 @@
 
 /**
  * This defines the \hat{d} Length in the paper.
+ *
+ * A Length is ordered by (length, numOfEdges, thisVertexIndex) and packed into two 64-bit words,
+ * so that comparing two Lengths takes at most two integer comparisons:
+ *  - encodedLength is the length encoded so that unsigned integer order equals the order of the path algebra, see Algebra;
+ *  - tieBreak holds numOfEdges in its high 32 bits and thisVertexIndex in its low 32 bits.
+ * The hop count makes a vertex strictly greater than its predecessor even over zero-length edges,
+ * and the vertex index makes the Lengths of different vertices distinct.
+ * The predecessor is not part of the key, it is kept by the solver (see BMSSP::getPredecessor).
+ * Vertex indices must therefore be below MAX_VERTICES.
  */
 class Length{
-    ActualLength length; // The sum of length of path from source to this vertex.
+    // The selection kernels in Selection.cpp load Lengths as pairs of 64-bit words, encodedLength first.
+    uint64_t encodedLength; // The order-preserving encoding of the sum of length of path from source to this vertex.
 
-    size_t numOfEdges; // The number of edges in the path
-    
-    VertexIndex prevVertexIndex; // The previous vertex in the path
-    
-    VertexIndex thisVertexIndex; // The index of this vertex
+    uint64_t tieBreak; // (numOfEdges << 32) | thisVertexIndex.
     // Though not specified in the paper,
     // we additionally store the index of this vertex to make various operations smoother.
 
+    static constexpr uint32_t NULL_INDEX32 = std::numeric_limits<uint32_t>::max();
+
+    static constexpr uint64_t encode(ActualLength len) { return Algebra::encode(len); }
+
+    static constexpr ActualLength decode(uint64_t bits) { return Algebra::decode(bits); }
+
+    static constexpr uint64_t packTieBreak(size_t edges, VertexIndex thisIndex) {
+        uint64_t hops = edges >= NULL_INDEX32 ? NULL_INDEX32 : edges;
+        uint64_t index = thisIndex == NULL_VERTEX ? NULL_INDEX32 : thisIndex;
+        assert(index <= NULL_INDEX32 && "Length only holds 32-bit vertex indices");
+        return (hops << 32) | index;
+    }
+
+    constexpr Length(uint64_t encoded, uint64_t tie) : encodedLength(encoded), tieBreak(tie) {}
+
 public:
 
-    constexpr Length(): Length(ActualLength{std::numeric_limits<double>::infinity()}, SIZE_MAX, NULL_VERTEX, NULL_VERTEX) {}
+    // The number of vertices a Length can index; NULL_VERTEX is stored as the largest 32-bit value.
+    static constexpr size_t MAX_VERTICES = NULL_INDEX32;
+
+    constexpr Length(): Length(Algebra::unreachable(), SIZE_MAX, NULL_VERTEX) {}
 
-    constexpr Length(ActualLength len, size_t edges, VertexIndex prevIndex, VertexIndex thisIndex)
-        : length(len), numOfEdges(edges), prevVertexIndex(prevIndex), thisVertexIndex(thisIndex) {}
+    constexpr Length(ActualLength len, size_t edges, VertexIndex thisIndex)
+        : encodedLength(encode(len)), tieBreak(packTieBreak(edges, thisIndex)) {}
 
     constexpr Length(Length&& other) = default;
     constexpr Length& operator=(Length&& other) = default;
     constexpr Length(const Length& other) = default;
     constexpr Length& operator=(const Length& other) = default;
 
-    static constexpr Length zero() { return Length(ActualLength{0.0}, 0, 0, 0); }
+    static constexpr Length zero() { return Length(Algebra::identity(), 0, 0); }
     static constexpr Length infinity() { return Length(); }
 
-    auto operator == (const Length& other) const {
-        return length == other.length &&
-               numOfEdges == other.numOfEdges &&
-               prevVertexIndex == other.prevVertexIndex &&
-               thisVertexIndex == other.thisVertexIndex;
+    constexpr bool operator == (const Length& other) const {
+        return (encodedLength == other.encodedLength) & (tieBreak == other.tieBreak);
     }
 
-    auto operator <=> (const Length& other) const {
-        return std::tie(length, numOfEdges, prevVertexIndex, thisVertexIndex) <=>
-            std::tie(other.length, other.numOfEdges, other.prevVertexIndex, other.thisVertexIndex);
-        // if (auto cmp = length <=> other.length; cmp != 0) { return cmp; }
-        // if (auto cmp = numOfEdges <=> other.numOfEdges; cmp != 0) { return cmp; }
-        // if (auto cmp = prevVertexIndex <=> other.prevVertexIndex; cmp != 0) { return cmp; }
-        // return thisVertexIndex <=> other.thisVertexIndex;
+    constexpr auto operator <=> (const Length& other) const {
+        if (auto cmp = encodedLength <=> other.encodedLength; cmp != 0) { return cmp; }
+        return tieBreak <=> other.tieBreak;
     }
 
+    // The relational operators are spelled out to keep them branchless.
+    constexpr bool operator < (const Length& other) const {
+        return (encodedLength < other.encodedLength) | ((encodedLength == other.encodedLength) & (tieBreak < other.tieBreak));
+    }
+    constexpr bool operator > (const Length& other) const { return other < *this; }
+    constexpr bool operator <= (const Length& other) const { return !(other < *this); }
+    constexpr bool operator >= (const Length& other) const { return !(*this < other); }
+
     friend std::ostream& operator<<(std::ostream& os, const Length& l) {
         if (l == Length::infinity()) { os << "{INF}"; }
         else if (l == Length::zero()) { os << "{ZERO}"; }
         else {
-            os << "{" << l.length << ", |" << l.numOfEdges << "|, " <<
-                (l.prevVertexIndex == NULL_VERTEX ? "N" : std::to_string(l.prevVertexIndex)) << " -> " <<
-                (l.thisVertexIndex == NULL_VERTEX ? "N" : std::to_string(l.thisVertexIndex)) << "}";
+            os << "{" << l.getLength() << ", |" << l.getNumOfEdges() << "|, -> " <<
+                (l.getIndex() == NULL_VERTEX ? "N" : std::to_string(l.getIndex())) << "}";
         }
         return os;
     }
 
-    VertexIndex getIndex() const { return thisVertexIndex; }
+    VertexIndex getIndex() const {
+        auto index = static_cast<uint32_t>(tieBreak);
+        return index == NULL_INDEX32 ? NULL_VERTEX : index;
+    }
+
+    // The two words of the key, which compare lexicographically as unsigned integers.
+    uint64_t getEncodedLength() const { return encodedLength; }
+    uint64_t getTieBreak() const { return tieBreak; }
+
+    size_t getNumOfEdges() const { return static_cast<size_t>(tieBreak >> 32); }
 
-	ActualLength getLength() const { return length; }
+	ActualLength getLength() const { return decode(encodedLength); }
 
     Length relax(const VertexIndex& to, ActualLength edgeLength) const {
-        return {length + edgeLength, numOfEdges + 1, thisVertexIndex, to};
+        return { encode(Algebra::combine(getLength(), edgeLength)), (tieBreak & ~uint64_t(NULL_INDEX32)) + (uint64_t(1) << 32) + packTieBreak(0, to) };
     }
 };
 
+static_assert(sizeof(Length) == 16, "Length is expected to be two 64-bit words");
+
 
 /**
  * @brief 
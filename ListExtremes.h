@@ -0,0 +1,45 @@
+#pragma once
+
+
+#include "Length.h"
+
+
+/**
+ * @brief ListExtremes caches the minimum and maximum keys of one list of vertices,
+ * so that Block::min and Block::max do not rescan the list each time.
+ *
+ * The cache is maintained incrementally as vertices are added, and as keys decrease.
+ * Since keys of distinct vertices are distinct, a removed key or an old key equal to a cached extreme
+ * means that the extreme vertex itself is gone or changed; only then is the cache marked dirty,
+ * and the next query rescans the list.
+ */
+struct ListExtremes {
+    Length min = Length::infinity(); // the minimum key, Length::infinity() if the list is empty.
+    Length max = Length::zero(); // the maximum key, Length::zero() if the list is empty.
+    bool dirty = false;
+
+    // A key is added to the list.
+    void add(const Length& key) {
+        min = std::min(min, key);
+        max = std::max(max, key);
+    }
+
+    // A key is removed from the list.
+    void remove(const Length& key) {
+        if (key == min || key == max) { dirty = true; }
+    }
+
+    // The key of a vertex in the list decreases from oldKey to newKey.
+    void decrease(const Length& oldKey, const Length& newKey) {
+        if (!(newKey < oldKey)) { return; }
+        if (oldKey == max) { dirty = true; }
+        min = std::min(min, newKey);
+    }
+
+    // Both lists are merged into the list of this.
+    void merge(const ListExtremes& other) {
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        dirty |= other.dirty;
+    }
+};
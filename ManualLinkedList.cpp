@@ -2,130 +2,144 @@
 
 
 VertexIndex ManualLinkedListBase::erase(VertexIndex v) {
-    VertexIndex &headId = head[v], &nextId = next[v], &prevId = prev[v];
-    DEBUG_MLL_LOG("Erasing vertex " << v << " from its old ManualLinkedList of id " << headId);
+    Node& node = nodes[v];
+    ListRecord& list = lists[node.head];
+    DEBUG_MLL_LOG("Erasing vertex " << v << " from its old ManualLinkedList of id " << node.head);
     debugPrint();
+    list.extremes.remove(dhat[v]);
     // redirect the pointers of the neighbors.
-    next[prevId] = nextId; // prev[v] should always be valid.
-    if (nextId != NULL_VERTEX) { prev[nextId] = prevId; }
-    else { head[headId] = prevId; } // v is the tail of the block, update the head of the block.
+    if (node.prev != NULL_NODE) { nodes[node.prev].next = node.next; }
+    else { list.first = node.next; } // v is the first of the block.
+    if (node.next != NULL_NODE) { nodes[node.next].prev = node.prev; }
+    else { list.tail = node.prev; } // v is the tail of the block.
     // update size of the block that v belongs to.
-    -- prev[headId];
+    -- list.size;
+    VertexIndex nextId = node.next == NULL_NODE ? NULL_VERTEX : node.next;
     // clear the pointers of this vertex.
-    headId = prevId = nextId = NULL_VERTEX;
+    node = Node{};
     return nextId;
 }
 
 
-void ManualLinkedListBase::recycleList(VertexIndex id) {
+void ManualLinkedListBase::recycleList(NodeIndex id) {
     DEBUG_MLL_LOG("Recycling ManualLinkedList with id " << id);
     debugPrint();
     // Add the block to the block pool.
-    next[id] = blockPool;
+    lists[id].first = blockPool;
     blockPool = id;
 }
 
 
 ManualLinkedList ManualLinkedListBase::newList() {
-    VertexIndex newId;
-    if (blockPool == NULL_VERTEX) {
+    NodeIndex newId;
+    if (blockPool == NULL_NODE) {
         // No recycled block available. Create a new one.
-        newId = prev.size();
-        prev.resize(newId + 1);
-        next.resize(newId + 1);
-        head.resize(newId + 1);
+        if (lists.size() >= NULL_NODE) { throw std::overflow_error("Too many blocks for the node indices of ManualLinkedListBase."); }
+        newId = static_cast<NodeIndex>(lists.size());
+        lists.emplace_back();
     } else {
         // There is a recycled block available. Reuse it.
         newId = blockPool;
-        blockPool = next[blockPool];        
+        blockPool = lists[blockPool].first;
     }
     DEBUG_MLL_LOG("Creating a new ManualLinkedList; newId: " << newId);
-    debugPrint();
-    return ManualLinkedList{shared_from_this(), newId};
+    return ManualLinkedList{*this, newId};
 }
 
 
 void ManualLinkedListBase::debugPrint() const {
 #if defined(DEBUG_MLL) && !defined(DEBUG_MLL_COMPRESS_OUTPUT)
+    auto str = [](NodeIndex i) { return i == NULL_NODE ? std::string("N") : std::to_string(i); };
     DEBUG_OS << "ManualLinkedListBase state:\nindx: \t";
-    for (auto i = 0; i < head.size(); ++i) { DEBUG_OS << (i == blockPool ? "B" : std::to_string(i)) << " \t"; }
+    for (size_t i = 0; i < nodes.size(); ++i) { DEBUG_OS << i << " \t"; }
     DEBUG_OS << std::endl << "prev: \t";
-    for (const auto& p : prev) { DEBUG_OS << (p == NULL_VERTEX ? "N" : std::to_string(p)) << " \t"; }
+    for (const auto& node : nodes) { DEBUG_OS << str(node.prev) << " \t"; }
     DEBUG_OS << std::endl << "next: \t";
-    for (const auto& n : next) { DEBUG_OS << (n == NULL_VERTEX ? "N" : std::to_string(n)) << " \t"; }
+    for (const auto& node : nodes) { DEBUG_OS << str(node.next) << " \t"; }
     DEBUG_OS << std::endl << "head: \t";
-    for (const auto& h : head) { DEBUG_OS << (h == NULL_VERTEX ? "N" : std::to_string(h)) << " \t"; }
+    for (const auto& node : nodes) { DEBUG_OS << str(node.head) << " \t"; }
+    DEBUG_OS << std::endl << "list: \t";
+    for (size_t i = 0; i < lists.size(); ++i) { DEBUG_OS << (i == blockPool ? "B" : std::to_string(i)) << " \t"; }
+    DEBUG_OS << std::endl << "size: \t";
+    for (const auto& list : lists) { DEBUG_OS << list.size << " \t"; }
+    DEBUG_OS << std::endl << "first:\t";
+    for (const auto& list : lists) { DEBUG_OS << str(list.first) << " \t"; }
+    DEBUG_OS << std::endl << "tail: \t";
+    for (const auto& list : lists) { DEBUG_OS << str(list.tail) << " \t"; }
     DEBUG_OS << std::endl;
 #endif // DEBUG
 }
 
 
 ManualLinkedList::~ManualLinkedList() {
-    auto pListBase = wpListBase.lock();
     if (!pListBase) {
-        DEBUG_MLL_LOG("Temporary ManualLinkedList object with id " << id << " is being destructed.");
+        DEBUG_MLL_LOG("Moved-from ManualLinkedList object with id " << id << " is being destructed.");
         return;
     }
+    auto pBase = base();
     DEBUG_MLL_LOG("Real ManualLinkedList object with id " << id << " is being destructed. BaseContent:");
-	pListBase->debugPrint();
-    for (auto it = next(id); it != NULL_VERTEX; it = pListBase->next[it]) { pListBase->head[it] = NULL_VERTEX; }
-    pListBase->recycleList(id);
+	pBase->debugPrint();
+    for (NodeIndex it = pBase->lists[id].first; it != NULL_NODE; ) {
+        auto& node = pBase->nodes[it];
+        it = node.next;
+        node = ManualLinkedListBase::Node{};
+    }
+    pBase->recycleList(id);
 }
 
 
 void ManualLinkedList::flushHead() {
-    for (auto it : *this) { wpListBase.lock()->head[it] = id; }
+    auto pBase = base();
+    for (NodeIndex it = pBase->lists[id].first; it != NULL_NODE; it = pBase->nodes[it].next) { pBase->nodes[it].head = id; }
 }
 
 
 void ManualLinkedList::add(VertexIndex v) {
     DEBUG_MLL_LOG("Adding vertex " << v << " to ManualLinkedList with id " << id);
-    auto pListBase = wpListBase.lock();
-    pListBase->debugPrint();
+    auto pBase = base();
+    pBase->debugPrint();
+    auto& node = pBase->nodes[v];
     // The vertex is already in this block, no need to add it again.
-    if (pListBase->head[v] == id) { return; }
+    if (node.head == id) { return; }
 
     // If the vertex is in another block, remove it from the old block.
-    if (pListBase->head[v] != NULL_VERTEX) { pListBase->erase(v); }
-
-    // New vertices are always inserted after the head of the block.
-    VertexIndex &nextId = pListBase->next[id];
-    pListBase->head[v] = id;
-    pListBase->prev[v] = id;
-    pListBase->next[v] = nextId;
-    if (nextId != NULL_VERTEX) { pListBase->prev[nextId] = v; }
-    else { pListBase->head[id] = v; } // v is the tail of the block.
-    nextId = v;
-    ++ pListBase->prev[id]; // update size of the block.
+    if (node.head != NULL_NODE) { pBase->erase(v); }
+
+    // New vertices are always inserted at the front of the block.
+    auto& list = pBase->lists[id];
+    node.head = id;
+    node.prev = NULL_NODE;
+    node.next = list.first;
+    if (list.first != NULL_NODE) { pBase->nodes[list.first].prev = static_cast<NodeIndex>(v); }
+    else { list.tail = static_cast<NodeIndex>(v); } // v is the tail of the block.
+    list.first = static_cast<NodeIndex>(v);
+    ++ list.size; // update size of the block.
+    list.extremes.add(pBase->dhat[v]);
 }
 
 
 void ManualLinkedList::merge(ManualLinkedList& other) {
-    DEBUG_MLL_LOG("Merging linked list of id " << other.id << " into the tail of linked list of id " << id);
-    auto pListBase = wpListBase.lock();
-    pListBase->debugPrint();
+    DEBUG_MLL_LOG("Merging linked list of id " << other.id << " into linked list of id " << id);
+    auto pBase = base();
+    pBase->debugPrint();
+    // Keep the larger block in place. If this block is empty, this just takes over the other block.
+    if (size() < other.size()) { std::swap(id, other.id); }
     // If the other block is empty, do nothing.
     if (other.empty()) { return; }
-    // If this block is empty, just take over the other block.
-    if (empty()) { std::swap(id, other.id); return; }
-    else {
-        // Both blocks are non-empty. Merge them.
-        VertexIndex thisTail = pListBase->head[id];
-        VertexIndex otherHead = pListBase->next[other.id];
-        VertexIndex otherTail = pListBase->head[other.id];
-        // Link the two blocks.
-        pListBase->next[thisTail] = otherHead;
-        pListBase->prev[otherHead] = thisTail;
-        pListBase->head[id] = otherTail;
-        // Update the head of all vertices in the other block to this id.
-        // Currently, other.begin() and other.end() are valid.
-        for (auto it : other) { pListBase->head[it] = id; }
-        // Update size of the block.
-        pListBase->prev[id] += pListBase->prev[other.id];
-        // Clear the other block.
-        pListBase->prev[other.id] = 0;
-        pListBase->next[other.id] = pListBase->head[other.id] = NULL_VERTEX;
-    }
+
+    // Both blocks are non-empty. Splice the other, smaller block after the tail of this block.
+    auto& list = pBase->lists[id];
+    auto& otherList = pBase->lists[other.id];
+    pBase->nodes[list.tail].next = otherList.first;
+    pBase->nodes[otherList.first].prev = list.tail;
+    list.tail = otherList.tail;
+    // Update the head of all vertices in the other block to this id, walking their interleaved nodes.
+    for (NodeIndex it = otherList.first; it != NULL_NODE; it = pBase->nodes[it].next) { pBase->nodes[it].head = id; }
+    // Update size and extremes of the block.
+    list.size += otherList.size;
+    list.extremes.merge(otherList.extremes);
+    // Clear the other block.
+    otherList = ManualLinkedListBase::ListRecord{};
 }
 
 
@@ -134,10 +148,10 @@ void ManualLinkedList::debugPrint() const {
     #ifdef DEBUG_MLL_COMPRESS_OUTPUT
 		DEBUG_OS << "{"; for (auto it : *this) { DEBUG_OS << std::setw(3) << it << "->"; } DEBUG_OS << "}";
     #else
-        auto pListBase = wpListBase.lock();
-        DEBUG_OS << "ManualLinkedList state for id " << id << ": size: " << pListBase->prev[id] << "; list: ";
+        auto pBase = base();
+        DEBUG_OS << "ManualLinkedList state for id " << id << ": size: " << pBase->lists[id].size << "; list: ";
         for (auto it : *this) { DEBUG_OS << std::setw(4) << it << " -> "; }
-        DEBUG_OS << " tail: " << pListBase->head[id] << std::endl;
+        DEBUG_OS << " tail: " << (pBase->lists[id].tail == NULL_NODE ? std::string("N") : std::to_string(pBase->lists[id].tail)) << std::endl;
     #endif
 #endif
 }
\ No newline at end of file
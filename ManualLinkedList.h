@@ -2,38 +2,53 @@
 
 
 #include "types.h"
+#include "DistanceTable.h"
+#include "ListExtremes.h"
+
+#include <utility>
 
 
 /**
  * @brief ManualLinkedListBase holds the memory base of the linked lists.
  * In this problem, blocks are maintained as linked lists, and blocks are disjoint.
- * Therefore, we can integrate them together by two vectors: prev and next.
+ * Therefore, we can integrate them together by one node per vertex, holding its prev, next and head.
  * And more importantly, we need to support the removal of vertices by their value,
  * which it is not very convenient to do with a std::list.
- * 
- * 0 ~ n-1 are for the vertices, from above n are for the blocks.
- * blocks are assigned to dynamic id but larger than n.
- * The head array stores the head of the block each vertex belongs to.
+ *
+ * The three links of a vertex are interleaved in one node, so that updating a vertex touches one cache line.
+ * The blocks have ids of their own, from 0, indexing a separate array of list records.
+ * The extremes of the keys of each block are cached in its record as well, see ListExtremes.
+ *
+ * The links are vertex indices, so VERTEX_INDEX_UINT32 (see Types.h) makes them 32-bit, which halves the nodes.
  */
 
+using NodeIndex = VertexIndex;
+constexpr NodeIndex NULL_NODE = std::numeric_limits<NodeIndex>::max();
+
 class ManualLinkedListBase : public std::enable_shared_from_this<ManualLinkedListBase> {
     friend class ManualLinkedList;
 
-    // stores the previous vertex in the linked list.
-    // for block heads, stores the size of the block.
-    std::vector<VertexIndex> prev;
+    struct Node {
+        NodeIndex prev = NULL_NODE; // the previous vertex in the block, NULL_NODE for the first one.
+        NodeIndex next = NULL_NODE; // the next vertex in the block, NULL_NODE for the last one.
+        NodeIndex head = NULL_NODE; // the id of the block the vertex belongs to, NULL_NODE if none.
+    };
 
-    // stores the next vertex in the linked list.
-    // for block tails, equals to INVALID_VERTEX to mark itself the end of the block.
-    std::vector<VertexIndex> next;
+    struct ListRecord {
+        NodeIndex size = 0;
+        NodeIndex first = NULL_NODE; // the first vertex; for recycled blocks, the next recycled block.
+        NodeIndex tail = NULL_NODE; // the last vertex.
+        ListExtremes extremes;
+    };
 
-    // stores the head of the block each vertex belongs to.
-    // if head[v] == INVALID_VERTEX, then v is not in any block.
-    // for BLOCK heads, stores the TAIL of the block.
-    std::vector<VertexIndex> head;
+    std::vector<Node> nodes; // nodes[v] for each vertex v.
 
-    VertexIndex blockPool; // A special linked list to keep track of the recycled blocks.
-    // Maintained as a forward list.
+    std::vector<ListRecord> lists; // lists[id] for each block id.
+
+    NodeIndex blockPool; // A special linked list to keep track of the recycled blocks.
+    // Maintained as a forward list through ListRecord::first.
+
+    const DistanceTable& dhat; // where the keys of the vertices are read from.
 
     // Remove a vertex from its current linked list.
     // Return the VertexIndex at the next position.
@@ -42,16 +57,23 @@ class ManualLinkedListBase : public std::enable_shared_from_this<ManualLinkedLis
 
     // Recycle a linked list block.
     // This is called when a ManualLinkedList is destructed.
-    void recycleList(VertexIndex id);
+    void recycleList(NodeIndex id);
 
     public:
-        ManualLinkedListBase(size_t s)
-            : prev(s, NULL_VERTEX), next(s, NULL_VERTEX), head(s, NULL_VERTEX), blockPool(NULL_VERTEX) {
-            DEBUG_MLL_LOG("Constructing ManualLinkedListBase of size: " << s);
+        ManualLinkedListBase(const DistanceTable& dhat)
+            : nodes(dhat.size()), blockPool(NULL_NODE), dhat(dhat) {
+            DEBUG_MLL_LOG("Constructing ManualLinkedListBase of size: " << dhat.size());
+            if (dhat.size() >= NULL_NODE) { throw std::overflow_error("Too many vertices for the node indices of ManualLinkedListBase."); }
         }
 
     // Create a new linked list.
     ManualLinkedList newList();
+
+    // Must be called right before dhat[v] decreases to newKey, to keep the extremes of the block of v.
+    void decreaseKey(VertexIndex v, const Length& newKey) {
+        NodeIndex id = nodes[v].head;
+        if (id != NULL_NODE) { lists[id].extremes.decrease(dhat[v], newKey); }
+    }
     
     void debugPrint() const;
 };
@@ -60,57 +82,92 @@ class ManualLinkedListBase : public std::enable_shared_from_this<ManualLinkedLis
  * @brief ManualLinkedList is a linked list of vertices.
  * It does not own the memory, so it can be copied and moved at a low cost.
  * Each ManualLinkedList serves for a block in FrontierManager.
+ *
+ * The base is reached through a plain pointer: its owner, the BMSSP solver, outlives every list it creates.
+ * With DEBUG_MLL_LIFETIME, each list also keeps a weak_ptr to the base and asserts on every access that it is alive.
  */
 class ManualLinkedList {
     friend class ManualLinkedListBase;
+    ManualLinkedListBase* pListBase; // nullptr once moved from.
+#ifdef DEBUG_MLL_LIFETIME
     std::weak_ptr<ManualLinkedListBase> wpListBase;
-    VertexIndex id;
-    // The size of a block is stored in prev[id], as id is always the head of the block.
+#endif
+    NodeIndex id;
+
+    ManualLinkedListBase* base() const {
+#ifdef DEBUG_MLL_LIFETIME
+        assert(!wpListBase.expired() && "ManualLinkedList is used after its ManualLinkedListBase is destructed");
+#endif
+        return pListBase;
+    }
 
     // Flush the head of all vertices in the block to the current id.
     void flushHead();
 
     // ManualLinkedList should only be created by ManualLinkedListBase::newList().
-    ManualLinkedList(std::shared_ptr<ManualLinkedListBase> base, VertexIndex id)
-        : wpListBase(base), id(id) {
-        base->prev[id] = 0; base->next[id] = base->head[id] = NULL_VERTEX;
+    ManualLinkedList(ManualLinkedListBase& base, NodeIndex id)
+        : pListBase(&base),
+#ifdef DEBUG_MLL_LIFETIME
+          wpListBase(base.weak_from_this()),
+#endif
+          id(id) {
+        base.lists[id] = {};
         DEBUG_MLL_LOG("Constructing ManualLinkedList of id: " << id);
-		base->debugPrint();
+		base.debugPrint();
     }
 
     public:
     
     // ManualLinkedList is so small that copying it is cheap.
-    ManualLinkedList(ManualLinkedList&& other) = default;
-    ManualLinkedList& operator=(ManualLinkedList&& other) = default;
+    // A moved-from list no longer refers to the block, so that only the new owner recycles it.
+    ManualLinkedList(ManualLinkedList&& other) noexcept
+        : pListBase(std::exchange(other.pListBase, nullptr)),
+#ifdef DEBUG_MLL_LIFETIME
+          wpListBase(std::move(other.wpListBase)),
+#endif
+          id(other.id) {}
+    ManualLinkedList& operator=(ManualLinkedList&& other) noexcept {
+        pListBase = std::exchange(other.pListBase, nullptr);
+#ifdef DEBUG_MLL_LIFETIME
+        wpListBase = std::move(other.wpListBase);
+#endif
+        id = other.id;
+        return *this;
+    }
     ManualLinkedList(const ManualLinkedList& other) = default;
     ManualLinkedList& operator=(const ManualLinkedList& other) = default;
 
     ~ManualLinkedList();
 
     class Iterator {
-        const ManualLinkedList& list;
-        VertexIndex current;
+        const ManualLinkedListBase* pListBase;
+        NodeIndex current;
     public:
-        constexpr Iterator(const ManualLinkedList& lst, VertexIndex start) : list(lst), current(start) {}
+        constexpr Iterator(const ManualLinkedListBase* base, NodeIndex start) : pListBase(base), current(start) {}
         Iterator(Iterator&& other) = delete;
         Iterator& operator=(ManualLinkedList::Iterator &&) = delete;
         Iterator(const Iterator& other) = default;
         Iterator& operator=(const ManualLinkedList::Iterator &) = default;
         VertexIndex operator*() const { return current; }
-        Iterator& operator++() { current = list.wpListBase.lock()->next[current]; return *this; }
+        Iterator& operator++() { current = pListBase->nodes[current].next; return *this; }
         bool operator!=(const Iterator& other) const { return current != other.current; }
     };
 
 	VertexIndex getId() const { return id; }
 
-    bool empty() const { return wpListBase.lock()->prev[id] == 0; }
+    bool empty() const { return base()->lists[id].size == 0; }
 
-    Iterator begin() const { return Iterator{*this, wpListBase.lock()->next[id]}; }
+    Iterator begin() const { return Iterator{base(), base()->lists[id].first}; }
 
-    constexpr Iterator end() const { return Iterator{*this, NULL_VERTEX}; }
+    Iterator end() const { return Iterator{base(), NULL_NODE}; }
 
-    size_t size() const { return wpListBase.lock()->prev[id]; }
+    size_t size() const { return base()->lists[id].size; }
+
+    // The cached extremes of the keys in this list, which must be rescanned if dirty.
+    const ListExtremes& getExtremes() const { return base()->lists[id].extremes; }
+
+    // Stores the rescanned extremes of the keys in this list.
+    void setExtremes(const Length& min, const Length& max) const { base()->lists[id].extremes = { min, max, false }; }
 
     // Prepare the block to be inserted into FrontierManager.
     void archive() { flushHead(); }
@@ -124,13 +181,12 @@ class ManualLinkedList {
     // Remove a vertex from its current linked list.
     // Return the VertexIndex at the next position.
     // caller responsible to check whether the vertex is in some block.
-    void erase(VertexIndex v) { wpListBase.lock()->erase(v); }
+    void erase(VertexIndex v) { base()->erase(v); }
 
-    VertexIndex next(VertexIndex v) const { return wpListBase.lock()->next[v]; }
-    
     // Merge another linked list into this linked list.
     // The other linked list will be empty after the merge.
-    // The complexity is linear to the size of the other linked list.
+    // The smaller list is spliced after the larger one, and only its vertices are relabeled,
+    // so the complexity is linear to the size of the smaller linked list.
     void merge(ManualLinkedList& other);
 
     void debugPrint() const;
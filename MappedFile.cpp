@@ -0,0 +1,130 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filename) {
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        throw std::runtime_error("Cannot read file size: " + filename);
+    }
+    if (fileSize.QuadPart == 0) {
+        // An empty file cannot be mapped; it is represented by an empty MappedFile.
+        CloseHandle(file);
+        return;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        throw std::runtime_error("Cannot map file: " + filename);
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Cannot map file: " + filename);
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    base = static_cast<const std::byte*>(view);
+    length = static_cast<size_t>(fileSize.QuadPart);
+}
+
+
+void MappedFile::unmap() {
+    if (base) { UnmapViewOfFile(base); }
+    if (mappingHandle) { CloseHandle(mappingHandle); }
+    if (fileHandle) { CloseHandle(fileHandle); }
+    base = nullptr;
+    length = 0;
+    fileHandle = mappingHandle = nullptr;
+}
+
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : base(other.base), length(other.length), fileHandle(other.fileHandle), mappingHandle(other.mappingHandle) {
+    other.base = nullptr;
+    other.length = 0;
+    other.fileHandle = other.mappingHandle = nullptr;
+}
+
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        std::swap(base, other.base);
+        std::swap(length, other.length);
+        std::swap(fileHandle, other.fileHandle);
+        std::swap(mappingHandle, other.mappingHandle);
+    }
+    return *this;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot read file size: " + filename);
+    }
+    if (st.st_size == 0) {
+        // An empty file cannot be mapped; it is represented by an empty MappedFile.
+        ::close(fd);
+        return;
+    }
+    void* view = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping keeps its own reference to the file, so the descriptor is no longer needed.
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        throw std::runtime_error("Cannot map file: " + filename);
+    }
+    base = static_cast<const std::byte*>(view);
+    length = static_cast<size_t>(st.st_size);
+}
+
+
+void MappedFile::unmap() {
+    if (base) { ::munmap(const_cast<std::byte*>(base), length); }
+    base = nullptr;
+    length = 0;
+}
+
+
+MappedFile::MappedFile(MappedFile&& other) noexcept : base(other.base), length(other.length) {
+    other.base = nullptr;
+    other.length = 0;
+}
+
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        std::swap(base, other.base);
+        std::swap(length, other.length);
+    }
+    return *this;
+}
+
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+
+#include "types.h"
+
+
+/**
+ * @brief MappedFile maps a whole file read-only into memory.
+ * The mapping lives as long as the MappedFile object, and pages are loaded by the OS on first touch.
+ * An empty file gives an empty MappedFile whose data() is nullptr.
+ * It is move-only; share it through a std::shared_ptr when several views need to keep it alive.
+ */
+class MappedFile {
+    const std::byte* base = nullptr;
+    size_t length = 0;
+
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+    void unmap();
+
+public:
+
+    // Maps the file. Throws std::runtime_error if the file cannot be opened or mapped.
+    explicit MappedFile(const std::string& filename);
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() { unmap(); }
+
+    const std::byte* data() const { return base; }
+
+    size_t size() const { return length; }
+};
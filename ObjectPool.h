@@ -0,0 +1,139 @@
+#pragma once
+
+
+#include "types.h"
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <utility>
+
+
+template <typename T>
+class ObjectPool;
+
+
+/**
+ * @brief PoolPtr is a reference counted handle to an object in an ObjectPool, a lighter std::shared_ptr.
+ * The count lives in the slot of the object (intrusive), and is not atomic, since the solver is single-threaded.
+ * When the last handle goes, the object is destructed and its slot returns to the free list of the pool.
+ */
+template <typename T>
+class PoolPtr {
+    friend class ObjectPool<T>;
+    using Slot = typename ObjectPool<T>::Slot;
+
+    Slot* slot = nullptr;
+
+    explicit PoolPtr(Slot* s) : slot(s) { ++ slot->refs; }
+
+    void release() {
+        if (slot && -- slot->refs == 0) { slot->pool->release(slot); }
+        slot = nullptr;
+    }
+
+public:
+
+    PoolPtr() = default;
+
+    PoolPtr(const PoolPtr& other) : slot(other.slot) { if (slot) { ++ slot->refs; } }
+    PoolPtr(PoolPtr&& other) noexcept : slot(std::exchange(other.slot, nullptr)) {}
+
+    PoolPtr& operator=(const PoolPtr& other) {
+        if (other.slot) { ++ other.slot->refs; } // counted first, in case of self-assignment.
+        release();
+        slot = other.slot;
+        return *this;
+    }
+    PoolPtr& operator=(PoolPtr&& other) noexcept {
+        if (this != &other) {
+            release();
+            slot = std::exchange(other.slot, nullptr);
+        }
+        return *this;
+    }
+
+    ~PoolPtr() { release(); }
+
+    T* get() const { return slot ? slot->object() : nullptr; }
+    T& operator*() const { return *slot->object(); }
+    T* operator->() const { return slot->object(); }
+    explicit operator bool() const { return slot != nullptr; }
+};
+
+
+/**
+ * @brief ObjectPool allocates objects of T in chunks of slots, and recycles the slots through a free list,
+ * so that the churn of short-lived objects, e.g. Blocks split and pulled in FrontierManager,
+ * does not hit the global allocator once the pool has grown to the peak number of live objects.
+ * Slots never move, so handles stay valid while the pool grows.
+ * The pool must outlive all handles to its objects.
+ */
+template <typename T>
+class ObjectPool {
+    friend class PoolPtr<T>;
+
+    struct Slot {
+        alignas(T) std::byte storage[sizeof(T)];
+        ObjectPool* pool;
+        size_t refs = 0;
+        Slot* nextFree = nullptr;
+
+        T* object() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    static constexpr size_t CHUNK_SIZE = 64;
+
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    Slot* freeList = nullptr;
+
+    size_t numOfLive = 0;
+    size_t peakLive = 0;
+
+    void grow() {
+        chunks.emplace_back(std::make_unique<Slot[]>(CHUNK_SIZE));
+        Slot* chunk = chunks.back().get();
+        for (size_t i = CHUNK_SIZE; i-- > 0; ) {
+            chunk[i].pool = this;
+            chunk[i].nextFree = freeList;
+            freeList = &chunk[i];
+        }
+    }
+
+    void release(Slot* slot) {
+        slot->object()->~T();
+        slot->nextFree = freeList;
+        freeList = slot;
+        -- numOfLive;
+    }
+
+public:
+
+    ObjectPool() = default;
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    ~ObjectPool() { assert(numOfLive == 0 && "ObjectPool destructed with live objects"); }
+
+    // Constructs an object of T from args in a free slot.
+    template <typename... Args>
+    PoolPtr<T> make(Args&&... args) {
+        if (!freeList) { grow(); }
+        Slot* slot = freeList;
+        new (slot->storage) T(std::forward<Args>(args)...); // the slot stays free if this throws.
+        freeList = slot->nextFree;
+        peakLive = std::max(peakLive, ++ numOfLive);
+        return PoolPtr<T>(slot);
+    }
+
+    // The number of objects alive now.
+    size_t getNumOfLive() const { return numOfLive; }
+
+    // The maximum number of objects alive at once, since construction or the last resetPeak().
+    size_t getPeakLive() const { return peakLive; }
+
+    // The number of slots allocated.
+    size_t getCapacity() const { return chunks.size() * CHUNK_SIZE; }
+
+    void resetPeak() { peakLive = numOfLive; }
+};
@@ -0,0 +1,101 @@
+#include "RadixFrontier.h"
+#include "BMSSP.h"
+
+#include <algorithm>
+
+
+void RadixFrontier::push(const Length& key) {
+    if (key.getEncodedLength() < base) {
+        throw std::logic_error("Key below the base of RadixFrontier.");
+    }
+    buckets[bucketOf(key)].push_back(key);
+}
+
+
+bool RadixFrontier::isStale(const Length& key) const {
+    return context.getKey(key.getIndex()) != key;
+}
+
+
+bool RadixFrontier::compact(size_t b) {
+    std::erase_if(buckets[b], [&](const Length& key) { return isStale(key); });
+    return !buckets[b].empty();
+}
+
+
+void RadixFrontier::rebase() {
+    size_t b = 0;
+    while (b < NUM_OF_BUCKETS && !compact(b)) { ++ b; }
+    if (b == 0 || b == NUM_OF_BUCKETS) { return; }
+    auto& bucket = buckets[b];
+    base = std::min_element(bucket.begin(), bucket.end())->getEncodedLength();
+    // Every key of bucket b shares the bits of the new base above bit b - 1, so each of them moves to a lower bucket.
+    for (const auto& key : bucket) { buckets[bucketOf(key)].push_back(key); }
+    bucket.clear();
+}
+
+
+Length RadixFrontier::minKey() {
+    for (size_t b = 0; b < NUM_OF_BUCKETS; ++b) {
+        if (compact(b)) { return *std::min_element(buckets[b].begin(), buckets[b].end()); }
+    }
+    return upperBound;
+}
+
+
+void RadixFrontier::insert(VertexIndex v) {
+    const Length& key = context.getKey(v);
+    if (key >= upperBound) { return; } // Ignore items that exceed the upper bound.
+    push(key);
+    currentLowerBound = std::min(currentLowerBound, key);
+}
+
+
+void RadixFrontier::insert(const VertexBuffer& vertices, Length lowerBound) {
+    for (auto v : vertices) {
+        const Length& key = context.getKey(v);
+        if (key < lowerBound || key >= upperBound) { continue; }
+        push(key);
+        currentLowerBound = std::min(currentLowerBound, key);
+    }
+}
+
+
+void RadixFrontier::batchPrepend(ShpBlock pBlock) {
+    DEBUG_FRONTIER_LOG("Batch-prepending " << *pBlock);
+    if (currentLowerBound < pBlock->max(context)) {
+        throw std::logic_error("pBlock max exceeds currentLowerBound in RadixFrontier::batchPrepend.");
+    }
+    if (pBlock -> empty()) { return; } // Ignore empty blocks.
+    currentLowerBound = std::min(currentLowerBound, pBlock->min(context));
+    for (auto v : *pBlock) { push(context.getKey(v)); }
+}
+
+
+std::pair<Length, ShpBlock> RadixFrontier::pull() {
+    DEBUG_FRONTIER_LOG("Pulling from RadixFrontier of capacity " << M << " with currentLowerBound = " << currentLowerBound);
+    rebase();
+    auto list = context.newList();
+    size_t b = 0;
+    while (list.size() < M && b < NUM_OF_BUCKETS) {
+        if (!compact(b)) { ++ b; continue; }
+        auto& bucket = buckets[b];
+        if (list.size() + bucket.size() <= M) {
+            for (const auto& key : bucket) { list.add(key.getIndex()); } // A repeated entry of a pulled vertex adds nothing.
+            bucket.clear();
+            ++ b;
+            continue;
+        }
+        // The keys no greater than the pivot come first, including the repeats of the pivot itself.
+        // If repeats made the list fall short of M, the loop goes on with the rest of this bucket.
+        auto [pivot, split] = selectMinQ(bucket, M - list.size(), context.getSelectionPolicy(), context.getSelectionScratch());
+        for (size_t i = 0; i < split; ++i) { list.add(bucket[i].getIndex()); }
+        bucket.erase(bucket.begin(), bucket.begin() + split);
+    }
+
+    Length lowerBound = currentLowerBound;
+    currentLowerBound = minKey();
+    auto S = context.newBlock(std::move(list), currentLowerBound, lowerBound, M);
+    DEBUG_FRONTIER_LOG("Pull from RadixFrontier: currentLowerBound updated to " << currentLowerBound << " and pulling " << *S);
+    return std::make_pair(currentLowerBound, S);
+}
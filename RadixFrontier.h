@@ -0,0 +1,71 @@
+#pragma once
+
+
+#include "Frontier.h"
+
+#include <array>
+
+
+class BMSSP; // Forward declaration to avoid circular dependency.
+
+
+/**
+ * @brief RadixFrontier is a Frontier on a radix heap of keys, bucketed by the encoded lengths, see Length.
+ * Bucket 0 holds the keys whose encoded length equals base, and bucket i > 0 those whose highest bit differing from base is bit i - 1,
+ * so that every key of a bucket is smaller than every key of the next one, and pushing a key costs one bit scan.
+ * It suits integer weights (see WeightTraits), whose encodings share their high bits, but works with any encoding.
+ *
+ * A radix heap needs every key pushed to be no less than base. Pull moves base up to the smallest key left, and no further:
+ * the keys pulled are no less than it, so are the bound B' returned by the recursion on them, and all keys inserted
+ * or batch-prepended afterwards, which lie in [B', B). The pulled keys themselves are not ordered within their buckets;
+ * the bucket holding the M-th of them is split by selectMinQ.
+ *
+ * Stale entries and repeated ones are handled as in HeapFrontier. The buckets live in a buffer of BMSSP for the recursion level.
+ */
+class RadixFrontier : public Frontier {
+public:
+    static constexpr size_t NUM_OF_BUCKETS = 65;
+    using Buckets = std::array<std::vector<Length>, NUM_OF_BUCKETS>;
+
+private:
+    BMSSP& context;
+    Buckets& buckets;
+    size_t M;
+    Length upperBound;
+    Length currentLowerBound;
+    uint64_t base = 0; // No greater than the encoded length of every key in the buckets, and of every key to come.
+
+    size_t bucketOf(const Length& key) const { return std::bit_width(key.getEncodedLength() ^ base); }
+
+    void push(const Length& key);
+
+    bool isStale(const Length& key) const;
+
+    // Drops the stale entries of bucket b, and returns whether any entry is left.
+    bool compact(size_t b);
+
+    // Moves base up to the smallest key left, redistributing the first non-empty bucket into the lower ones.
+    void rebase();
+
+    // The smallest key left, or upperBound if none.
+    Length minKey();
+
+public:
+
+    // Every bucket of storage is cleared, and the buckets are used during the lifetime of this frontier.
+    RadixFrontier(BMSSP& ctx, Buckets& storage, size_t m, Length ub)
+    : context(ctx), buckets(storage), M(m), upperBound(ub), currentLowerBound(ub) {
+        DEBUG_FRONTIER_LOG("Constructing RadixFrontier with M = " << M << ", upperBound = " << upperBound);
+        for (auto& bucket : buckets) { bucket.clear(); }
+    }
+
+    void insert(VertexIndex v) override;
+
+    void insert(const VertexBuffer& vertices, Length lowerBound = Length::zero()) override;
+
+    void batchPrepend(ShpBlock pBlock) override;
+
+    std::pair<Length, ShpBlock> pull() override;
+
+    Length getCurrentLowerBound() const override { return currentLowerBound; }
+};
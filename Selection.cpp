@@ -0,0 +1,357 @@
+#include "Selection.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define DISSSP_X86_64
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define DISSSP_TARGET(isa)
+#else
+#define DISSSP_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+
+namespace {
+
+    static_assert(sizeof(Length) == 2 * sizeof(uint64_t) && std::is_trivially_copyable_v<Length>,
+        "The partition kernels treat a Length as two 64-bit words");
+
+    // Ranges of at most this many keys are finished by insertion sort.
+    constexpr size_t SMALL_SELECTION = 32;
+
+    /**
+     * All kernels share the same layout: the keys going left are compacted in place at the front of keys,
+     * which never overtakes the read position, while the keys going right are appended to scratch.
+     * Finally the right side is copied back behind the left side.
+     */
+    size_t gatherRightSide(Length* keys, size_t n, size_t numLeft, const Length* scratch) {
+        std::memcpy(static_cast<void*>(keys + numLeft), scratch, (n - numLeft) * sizeof(Length));
+        return numLeft;
+    }
+
+    template <bool Strict>
+    size_t partitionTailScalar(Length* keys, size_t i, size_t n, const Length& pivot, Length* scratch, size_t numLeft, size_t numRight) {
+        for (; i < n; ++i) {
+            Length key = keys[i];
+            bool left = Strict ? key < pivot : key <= pivot;
+            keys[numLeft] = key;
+            scratch[numRight] = key;
+            numLeft += left;
+            numRight += !left;
+        }
+        return gatherRightSide(keys, n, numLeft, scratch);
+    }
+
+    template <bool Strict>
+    size_t partitionScalar(Length* keys, size_t n, const Length& pivot, Length* scratch) {
+        return partitionTailScalar<Strict>(keys, 0, n, pivot, scratch, 0, 0);
+    }
+
+#ifdef DISSSP_X86_64
+
+    // Two keys per 256-bit vector. The 64-bit compares are signed, so both sides get their sign bit flipped.
+    // cmp holds one bit per word: bit 0/1 for the two words of the first key, bit 2/3 for the second.
+    template <bool Strict>
+    DISSSP_TARGET("avx2") size_t partitionAVX2(Length* keys, size_t n, const Length& pivot, Length* scratch) {
+        const __m256i flip = _mm256_set1_epi64x(std::numeric_limits<int64_t>::min());
+        const __m256i p = _mm256_xor_si256(flip, _mm256_setr_epi64x(
+            static_cast<int64_t>(pivot.getEncodedLength()), static_cast<int64_t>(pivot.getTieBreak()),
+            static_cast<int64_t>(pivot.getEncodedLength()), static_cast<int64_t>(pivot.getTieBreak())));
+        size_t numLeft = 0, numRight = 0, i = 0;
+        for (; i + 2 <= n; i += 2) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+            __m256i x = _mm256_xor_si256(v, flip);
+            // Strict: whether key < pivot word by word; otherwise whether key > pivot.
+            __m256i before = Strict ? _mm256_cmpgt_epi64(p, x) : _mm256_cmpgt_epi64(x, p);
+            unsigned b = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(before)));
+            unsigned e = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(x, p))));
+            unsigned cmp = b | (e & (b >> 1)); // Lexicographic result of each key in bits 0 and 2.
+            bool left0 = ((cmp & 1) != 0) == Strict;
+            bool left1 = ((cmp & 4) != 0) == Strict;
+
+            __m128i k0 = _mm256_castsi256_si128(v);
+            __m128i k1 = _mm256_extracti128_si256(v, 1);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(keys + numLeft), k0);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(scratch + numRight), k0);
+            numLeft += left0;
+            numRight += !left0;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(keys + numLeft), k1);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(scratch + numRight), k1);
+            numLeft += left1;
+            numRight += !left1;
+        }
+        return partitionTailScalar<Strict>(keys, i, n, pivot, scratch, numLeft, numRight);
+    }
+
+    // Four keys per 512-bit vector, compacted with compress; each store may spill past its side by up to 3 keys,
+    // which only overwrites keys already loaded, or the slack at the end of scratch.
+    template <bool Strict>
+    DISSSP_TARGET("avx512f") size_t partitionAVX512(Length* keys, size_t n, const Length& pivot, Length* scratch) {
+        const auto encoded = static_cast<int64_t>(pivot.getEncodedLength()), tie = static_cast<int64_t>(pivot.getTieBreak());
+        const __m512i p = _mm512_set4_epi64(tie, encoded, tie, encoded);
+        size_t numLeft = 0, numRight = 0, i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m512i v = _mm512_loadu_si512(keys + i);
+            unsigned b = Strict ? _mm512_cmplt_epu64_mask(v, p) : _mm512_cmpgt_epu64_mask(v, p);
+            unsigned e = _mm512_cmpeq_epu64_mask(v, p);
+            unsigned cmp = (b | (e & (b >> 1))) & 0x55; // Lexicographic result of each key in the even bits.
+            unsigned leftKeys = Strict ? cmp : (~cmp & 0x55);
+            auto leftLanes = static_cast<__mmask8>(leftKeys | (leftKeys << 1));
+            _mm512_storeu_si512(keys + numLeft, _mm512_maskz_compress_epi64(leftLanes, v));
+            _mm512_storeu_si512(scratch + numRight, _mm512_maskz_compress_epi64(static_cast<__mmask8>(~leftLanes), v));
+            size_t numLeftKeys = static_cast<size_t>(std::popcount(leftKeys));
+            numLeft += numLeftKeys;
+            numRight += 4 - numLeftKeys;
+        }
+        return partitionTailScalar<Strict>(keys, i, n, pivot, scratch, numLeft, numRight);
+    }
+
+#endif
+
+    bool detectSupport(PartitionKernel kernel) {
+        if (kernel == PartitionKernel::Scalar) { return true; }
+#ifdef DISSSP_X86_64
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 1);
+        if (!(info[2] & (1 << 27))) { return false; } // OSXSAVE
+        unsigned long long xcr0 = _xgetbv(0);
+        __cpuidex(info, 7, 0);
+        bool avx2 = (info[1] & (1 << 5)) && (xcr0 & 0x6) == 0x6;
+        if (kernel == PartitionKernel::AVX2) { return avx2; }
+        return avx2 && (info[1] & (1 << 16)) && (xcr0 & 0xE6) == 0xE6;
+#else
+        __builtin_cpu_init();
+        if (kernel == PartitionKernel::AVX2) { return __builtin_cpu_supports("avx2"); }
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("avx512f");
+#endif
+#else
+        return false;
+#endif
+    }
+
+    PartitionKernel& currentKernel() {
+        static PartitionKernel kernel =
+            detectSupport(PartitionKernel::AVX512) ? PartitionKernel::AVX512 :
+            detectSupport(PartitionKernel::AVX2) ? PartitionKernel::AVX2 : PartitionKernel::Scalar;
+        return kernel;
+    }
+
+    void insertionSort(Length* keys, size_t n) {
+        for (size_t i = 1; i < n; ++i) {
+            Length key = keys[i];
+            size_t j = i;
+            for (; j > 0 && key < keys[j - 1]; --j) { keys[j] = keys[j - 1]; }
+            keys[j] = key;
+        }
+    }
+
+    Length medianOf5(const Length* group) {
+        Length g[5] = { group[0], group[1], group[2], group[3], group[4] };
+        insertionSort(g, 5);
+        return g[2];
+    }
+
+    Length medianOf3(const Length& a, const Length& b, const Length& c) {
+        return std::max(std::min(a, b), std::min(std::max(a, b), c));
+    }
+
+    // Partitions keys[0, n) by pivot, which must be one of the keys, and narrows the range to the side holding rank r.
+    // Returns true if the key of rank r turned out to equal the pivot, in which case the selection is done.
+    bool narrowByPivot(Length*& keys, size_t& n, size_t& r, const Length& pivot, Length* scratch) {
+        size_t numNoGreater = partitionKeys(keys, n, pivot, false, scratch);
+        if (r >= numNoGreater) {
+            keys += numNoGreater;
+            n -= numNoGreater;
+            r -= numNoGreater;
+            return false;
+        }
+        if (numNoGreater < n) {
+            n = numNoGreater;
+            return false;
+        }
+        // No key is greater than the pivot, so split off the keys equal to it to make progress.
+        size_t numLess = partitionKeys(keys, n, pivot, true, scratch);
+        if (r >= numLess) { return true; } // keys[numLess, n) all equal the pivot.
+        n = numLess;
+        return false;
+    }
+
+    // The practical policies may partition this many keys per input key before falling back to the median of medians,
+    // which keeps them worst-case linear.
+    constexpr size_t WORK_BUDGET_FACTOR = 4;
+
+    // Floyd-Rivest only samples ranges larger than this; smaller ones take a median-of-3 pivot.
+    constexpr size_t FLOYD_RIVEST_SAMPLING = 600;
+
+    // The range [first, last] of keys around rank r from which Floyd-Rivest selects its pivot, about n^(2/3) keys.
+    std::pair<size_t, size_t> floydRivestSample(size_t n, size_t r) {
+        double dn = static_cast<double>(n), dr = static_cast<double>(r);
+        double z = std::log(dn);
+        double s = 0.5 * std::exp(2.0 * z / 3.0);
+        double sd = 0.5 * std::sqrt(z * s * (dn - s) / dn) * (dr < dn / 2 ? -1.0 : 1.0);
+        auto first = static_cast<size_t>(std::max(0.0, dr - dr * s / dn + sd));
+        auto last = static_cast<size_t>(std::min(dn - 1.0, dr + (dn - dr) * s / dn + sd));
+        return { std::min(first, r), std::max(last, r) };
+    }
+}
+
+
+/**
+ * Radix selection: the range keys[lo, hi) holding the target rank r narrows to the keys sharing the current byte with it,
+ * from the most significant byte of encodedLength to the least significant byte of tieBreak.
+ * Each round counts the bytes, and unless all keys share the byte, distributes the range into buffer by
+ * (less, equal, greater) than the byte of the target bucket and copies it back.
+ * Once all bytes are done, the range holds the keys equal to the pivot.
+ */
+static SelectionResult radixSelect(std::span<Length> keys, size_t q, Length* buffer) {
+    size_t lo = 0, hi = keys.size(), r = q - 1;
+    for (int round = 0; round < 16 && hi - lo > 1; ++round) {
+        bool high = round < 8;
+        unsigned shift = 8 * (7 - round % 8);
+        auto digit = [&](const Length& key) { return ((high ? key.getEncodedLength() : key.getTieBreak()) >> shift) & 0xFF; };
+
+        size_t count[256] = {};
+        for (size_t i = lo; i < hi; ++i) { ++ count[digit(keys[i])]; }
+        size_t below = lo, target = 0;
+        while (below + count[target] <= r) { below += count[target ++]; }
+        if (count[target] == hi - lo) { continue; }
+
+        size_t less = 0, equal = below - lo, greater = equal + count[target];
+        for (size_t i = lo; i < hi; ++i) {
+            auto d = digit(keys[i]);
+            size_t& pos = d < target ? less : (d == target ? equal : greater);
+            buffer[pos ++] = keys[i];
+        }
+        std::copy(buffer, buffer + (hi - lo), keys.begin() + lo);
+        hi = below + count[target];
+        lo = below;
+    }
+    return { keys[r], hi };
+}
+
+
+/**
+ * All policies run on one loop over an explicit stack of frames.
+ * A frame narrows its range keys[0, n) round by round, keeping the key of rank r inside.
+ * When the pivot of a round needs a selection of its own (the median of the medians, or the Floyd-Rivest sample),
+ * the frame pushes a child frame and waits; the child leaves the pivot at pivotSlot.
+ *
+ * The frame of the median of medians keeps the medians behind its partition area in the scratch buffer,
+ * and its child frame uses the buffer behind the medians, so the buffer needs at most 2n + 64 keys.
+ * A Floyd-Rivest sample is selected in place within the range of its parent, which is idle meanwhile.
+ */
+SelectionResult selectMinQ(std::span<Length> keys, size_t q, SelectionPolicy policy, SelectionScratch& scratch) {
+    if (q == 0 || q > keys.size()) { throw std::out_of_range("q is out of range in selectMinQ"); }
+    if (scratch.buffer.size() < 2 * keys.size() + 64) { scratch.buffer.resize(2 * keys.size() + 64); }
+    if (policy == SelectionPolicy::Radix) { return radixSelect(keys, q, scratch.buffer.data()); }
+    auto& stack = scratch.stack;
+    stack.clear();
+    stack.push_back({ keys.data(), keys.size(), q - 1, scratch.buffer.data(), WORK_BUDGET_FACTOR * keys.size(), policy });
+
+    size_t split = q;
+    while (!stack.empty()) {
+        // Children are pushed only at the end of an iteration, so the reference stays valid.
+        auto& f = stack.back();
+        bool isRoot = stack.size() == 1;
+        bool done = false;
+        if (f.pivotSlot) {
+            // The child frame has selected the pivot.
+            Length pivot = *f.pivotSlot;
+            f.pivotSlot = nullptr;
+            done = narrowByPivot(f.keys, f.n, f.r, pivot, f.scratch);
+            if (done && isRoot) { split = static_cast<size_t>(f.keys - keys.data()) + f.n; } // The run of keys equal to the pivot ends there.
+        }
+        else if (f.n <= SMALL_SELECTION) {
+            insertionSort(f.keys, f.n);
+            done = true;
+            if (isRoot) {
+                size_t end = f.r + 1;
+                while (end < f.n && f.keys[end] == f.keys[f.r]) { ++end; }
+                split = static_cast<size_t>(f.keys - keys.data()) + end;
+            }
+        }
+        else {
+            if (f.policy != SelectionPolicy::StrictLinear) {
+                if (f.budget < f.n) { f.policy = SelectionPolicy::StrictLinear; }
+                else { f.budget -= f.n; }
+            }
+
+            if (f.policy == SelectionPolicy::StrictLinear) {
+                // The median of the medians of contiguous groups of 5.
+                // The medians are gathered behind the area used for partitioning.
+                size_t numOfGroups = f.n / 5;
+                Length* medians = f.scratch + f.n + 8;
+                for (size_t g = 0; g < numOfGroups; ++g) { medians[g] = medianOf5(f.keys + 5 * g); }
+                f.pivotSlot = medians + numOfGroups / 2;
+                stack.push_back({ medians, numOfGroups, numOfGroups / 2, medians + numOfGroups + 8, 0, SelectionPolicy::StrictLinear });
+                continue;
+            }
+            if (f.policy == SelectionPolicy::FloydRivest && f.n > FLOYD_RIVEST_SAMPLING) {
+                auto [first, last] = floydRivestSample(f.n, f.r);
+                size_t sampleSize = last - first + 1;
+                f.pivotSlot = f.keys + f.r;
+                stack.push_back({ f.keys + first, sampleSize, f.r - first, f.scratch, WORK_BUDGET_FACTOR * sampleSize, SelectionPolicy::FloydRivest });
+                continue;
+            }
+            done = narrowByPivot(f.keys, f.n, f.r, medianOf3(f.keys[0], f.keys[f.n / 2], f.keys[f.n - 1]), f.scratch);
+            if (done && isRoot) { split = static_cast<size_t>(f.keys - keys.data()) + f.n; }
+        }
+        if (done) { stack.pop_back(); }
+    }
+    return { keys[q - 1], split };
+}
+
+
+bool isPartitionKernelSupported(PartitionKernel kernel) { return detectSupport(kernel); }
+
+PartitionKernel getPartitionKernel() { return currentKernel(); }
+
+bool setPartitionKernel(PartitionKernel kernel) {
+    if (!detectSupport(kernel)) { return false; }
+    currentKernel() = kernel;
+    return true;
+}
+
+const char* getPartitionKernelName(PartitionKernel kernel) {
+    switch (kernel) {
+    case PartitionKernel::AVX512: return "AVX-512";
+    case PartitionKernel::AVX2: return "AVX2";
+    default: return "Scalar";
+    }
+}
+
+
+size_t partitionKeys(Length* keys, size_t n, const Length& pivot, bool strict, Length* scratch) {
+    switch (currentKernel()) {
+#ifdef DISSSP_X86_64
+    case PartitionKernel::AVX512:
+        return strict ? partitionAVX512<true>(keys, n, pivot, scratch) : partitionAVX512<false>(keys, n, pivot, scratch);
+    case PartitionKernel::AVX2:
+        return strict ? partitionAVX2<true>(keys, n, pivot, scratch) : partitionAVX2<false>(keys, n, pivot, scratch);
+#endif
+    default:
+        return strict ? partitionScalar<true>(keys, n, pivot, scratch) : partitionScalar<false>(keys, n, pivot, scratch);
+    }
+}
+
+
+const char* getSelectionPolicyName(SelectionPolicy policy) {
+    switch (policy) {
+    case SelectionPolicy::IntroSelect: return "IntroSelect";
+    case SelectionPolicy::FloydRivest: return "FloydRivest";
+    case SelectionPolicy::Radix: return "Radix";
+    default: return "StrictLinear";
+    }
+}
+
+
+Length selectMinQ(std::span<Length> keys, size_t q, SelectionPolicy policy) {
+    SelectionScratch scratch;
+    return selectMinQ(keys, q, policy, scratch).pivot;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+
+#include "Length.h"
+
+#include <span>
+#include <vector>
+
+
+/**
+ * @brief Selection on contiguous arrays of Length keys.
+ *
+ * This is the counterpart of linearLocateMinQ for the keys gathered by Block and FrontierManager.
+ * Instead of striding through the array, the median-of-medians pivot is computed from contiguous groups of 5
+ * into a separate array, and every round partitions the remaining range with a vectorized kernel.
+ * It keeps the worst-case linear time of linearLocateMinQ.
+ *
+ * The partition kernel is picked once at runtime from what the CPU supports:
+ * AVX-512 compress, AVX2 compares with branchless stores, or a portable branchless scalar loop.
+ */
+enum class PartitionKernel { Scalar, AVX2, AVX512 };
+
+// The kernel in use, detected on first use.
+PartitionKernel getPartitionKernel();
+
+// Whether the CPU supports the kernel.
+bool isPartitionKernelSupported(PartitionKernel kernel);
+
+// Forces a kernel, mainly for testing and benchmarking.
+// Returns false and keeps the current kernel if the CPU does not support it.
+bool setPartitionKernel(PartitionKernel kernel);
+
+const char* getPartitionKernelName(PartitionKernel kernel);
+
+/**
+ * @brief
+ * Partitions keys[0, n) so that the keys less than pivot (strict) or no greater than pivot (!strict) come first,
+ * and returns their number. The order within each side is not preserved.
+ *
+ * @param scratch A buffer of at least n + 8 keys, whose contents are clobbered.
+ */
+size_t partitionKeys(Length* keys, size_t n, const Length& pivot, bool strict, Length* scratch);
+
+/**
+ * @brief The selection algorithms behind selectMinQ.
+ * StrictLinear: median of medians, worst-case linear as the paper requires, but with a large constant.
+ * IntroSelect: quickselect on a median-of-3 pivot, like std::nth_element,
+ *              but it falls back to the median of medians instead of heap select once it has partitioned 4n keys.
+ * FloydRivest: Floyd-Rivest selection, which picks the pivot from a sample around the target rank,
+ *              with the same fallback as IntroSelect.
+ * Radix: most significant digit radix selection on the two words of the keys, a byte per round,
+ *        which makes no comparisons and narrows the range to the bucket of the target rank each round.
+ *        It takes at most 16 linear rounds, and rounds where all keys share the byte cost only the histogram.
+ *        Integer weights (see WeightTraits) leave the high bytes of the lengths equal, which suits it best.
+ * All of them are linear in the worst case; the latter three are much faster than the first on typical inputs.
+ */
+enum class SelectionPolicy { StrictLinear, IntroSelect, FloydRivest, Radix };
+
+const char* getSelectionPolicyName(SelectionPolicy policy);
+
+// The outcome of selectMinQ.
+struct SelectionResult {
+    Length pivot; // The q-th smallest key.
+    size_t split; // The number of keys no greater than pivot, which come first after the selection.
+};
+
+// One pending range of selectMinQ, see Selection.cpp.
+struct SelectionFrame {
+    Length* keys;
+    size_t n;
+    size_t r; // The 0-based rank to select within keys[0, n).
+    Length* scratch;
+    size_t budget; // The keys the practical policies may still partition before falling back.
+    SelectionPolicy policy;
+    const Length* pivotSlot = nullptr; // Where a child frame leaves the pivot of this frame, if one is pending.
+};
+
+/**
+ * @brief SelectionScratch holds the buffers of selectMinQ, so that selections allocate nothing
+ * once the buffers have grown to their working size. The solver owns one and reuses it for every selection.
+ * Callers may also gather the keys to select from into getKeys().
+ */
+class SelectionScratch {
+    std::vector<Length> keys;
+    std::vector<Length> buffer; // The partition area of each frame, each followed by its medians.
+    std::vector<SelectionFrame> stack;
+
+    friend SelectionResult selectMinQ(std::span<Length> keys, size_t q, SelectionPolicy policy, SelectionScratch& scratch);
+
+public:
+    std::vector<Length>& getKeys() { return keys; }
+};
+
+/**
+ * @brief
+ * Rearranges keys so that keys[q - 1] is the q-th smallest key, every key before it is no greater,
+ * and every key after it is no less. Moreover, keys[0, split) are exactly the keys no greater than it.
+ * This function runs in worst-case linear time with every policy, iteratively over an explicit stack.
+ */
+SelectionResult selectMinQ(std::span<Length> keys, size_t q, SelectionPolicy policy, SelectionScratch& scratch);
+
+// The same as above with a scratch of its own. Returns the q-th smallest key.
+Length selectMinQ(std::span<Length> keys, size_t q, SelectionPolicy policy = SelectionPolicy::StrictLinear);
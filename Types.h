@@ -2,27 +2,47 @@
 
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 
+#include <algorithm>
 #include <cmath>
 #include <bit>
 #include <limits>
 #include <random>
 
 #include <forward_list>
-#include <list>
 #include <map>
 #include <set>
+#include <span>
 #include <stack>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 #include "debug.h"
 
 
 // We do not maintain vertex objects, they are uniquely identified by their index.
+// Defining VERTEX_INDEX_UINT32 makes the indices 32-bit, which shrinks the CSR targets, the list nodes and the arrays of the solver,
+// for graphs of fewer than 2^32 - 1 vertices, counting the gadget vertices of the constant-degree transformation.
+// Length holds 32-bit indices in either case.
+#ifdef VERTEX_INDEX_UINT32
+using VertexIndex = uint32_t;
+#else
 using VertexIndex = size_t;
+#endif
 constexpr VertexIndex NULL_VERTEX = std::numeric_limits<VertexIndex>::max();
 
+// Edges are identified by their position in the CSR arrays of a Graph.
+// Defining EDGE_INDEX_UINT32 makes the CSR offsets 32-bit, for graphs of fewer than 2^32 edges.
+// The loaders and Graph::addEdge throw std::overflow_error on graphs too large for either index type.
+#ifdef EDGE_INDEX_UINT32
+using EdgeIndex = uint32_t;
+#else
+using EdgeIndex = size_t;
+#endif
+constexpr size_t MAX_NUM_OF_EDGES = std::numeric_limits<EdgeIndex>::max();
+
 
 /**
  * Our algorithm works under the Comparison-Addition Model:
@@ -39,13 +59,134 @@ constexpr VertexIndex NULL_VERTEX = std::numeric_limits<VertexIndex>::max();
  *
  * For Single-Source Shortest Path problem, monoid (R_{>=0}, 0, +, <) works.
  * For Single-Source Bottleneck Path problem, monoid (R\cup{-\infty}, -\infty, max, <) works.
+ * The solver runs on the monoid given by Algebra below, see PATH_ALGEBRA_BOTTLENECK and PATH_ALGEBRA_WIDEST.
  *
- * For simplicity, we use double as the length type.
+ * By default, we use double as the length type.
  * We are ignoring truncation errors and floating-point precision issues in this project.
- * Future developers may define ActualLength as any custom type that satisfies the above properties.
+ * Defining WEIGHT_UINT32 or WEIGHT_UINT64 makes lengths unsigned integers instead,
+ * whose comparisons are exact, for graphs of integer weights (e.g. milliseconds or metres).
+ * Future developers may define ActualLength as any custom type that satisfies the above properties,
+ * and specialize WeightTraits for it.
  */
 
+#if defined(WEIGHT_UINT32)
+using ActualLength = uint32_t;
+#elif defined(WEIGHT_UINT64)
+using ActualLength = uint64_t;
+#else
 using ActualLength = double;
+#endif
+
+
+/**
+ * @brief WeightTraits describes what the solver needs of a length type besides comparison and addition:
+ * its zero and infinity, an order-preserving encoding into 64-bit unsigned integers (see Length),
+ * and the distribution of random weights for genRandGraph2File.
+ */
+template <typename T>
+struct WeightTraits;
+
+template <>
+struct WeightTraits<double> {
+    static constexpr bool isInteger = false;
+
+    static constexpr double zero() { return 0.0; }
+    static constexpr double infinity() { return std::numeric_limits<double>::infinity(); }
+
+    static constexpr double add(double a, double b) { return a + b; }
+
+    // Maps the bit pattern of the double, so that unsigned integer order equals floating point order.
+    static constexpr uint64_t encode(double len) {
+        uint64_t bits = std::bit_cast<uint64_t>(len);
+        return (bits >> 63) ? ~bits : (bits | (uint64_t(1) << 63));
+    }
+
+    static constexpr double decode(uint64_t bits) {
+        return std::bit_cast<double>((bits >> 63) ? (bits & ~(uint64_t(1) << 63)) : ~bits);
+    }
+
+    using Distribution = std::uniform_real_distribution<double>;
+};
+
+// Unsigned integer lengths, whose largest value stands for infinity. Sums saturate at it.
+template <typename T>
+struct UnsignedWeightTraits {
+    static_assert(std::is_unsigned_v<T> && sizeof(T) <= sizeof(uint64_t), "UnsignedWeightTraits is for unsigned integers of up to 64 bits");
+
+    static constexpr bool isInteger = true; // Comparisons and additions are exact.
+
+    static constexpr T zero() { return 0; }
+    static constexpr T infinity() { return std::numeric_limits<T>::max(); }
+
+    static constexpr T add(T a, T b) { return a > infinity() - b ? infinity() : a + b; }
+
+    static constexpr uint64_t encode(T len) { return len; }
+
+    static constexpr T decode(uint64_t bits) { return static_cast<T>(bits); }
+
+    using Distribution = std::uniform_int_distribution<T>;
+};
+
+template <>
+struct WeightTraits<uint32_t> : UnsignedWeightTraits<uint32_t> {};
+
+template <>
+struct WeightTraits<uint64_t> : UnsignedWeightTraits<uint64_t> {};
+
+using Weights = WeightTraits<ActualLength>;
+
+
+/**
+ * @brief The path algebras, i.e. the monoids (identity, combine, order) the solver may run on, on lengths of type T.
+ * The order is given by encode: the smaller the encoding, the better the path,
+ * so that Length compares encoded words whatever the algebra, and combine is inlined into Length::relax.
+ * identity() is the value of the empty path, which is also the length of the arcs added by the constant-degree transformation.
+ * unreachable() is no better than the value of any path, and is the value of the vertices not reached yet.
+ */
+
+// Shortest path: (0, +, <).
+template <typename T>
+struct ShortestPath {
+    static constexpr uint32_t id = 0;
+
+    static constexpr T identity() { return WeightTraits<T>::zero(); }
+    static constexpr T unreachable() { return WeightTraits<T>::infinity(); }
+    static constexpr T combine(T path, T arc) { return WeightTraits<T>::add(path, arc); }
+
+    static constexpr uint64_t encode(T len) { return WeightTraits<T>::encode(len); }
+    static constexpr T decode(uint64_t bits) { return WeightTraits<T>::decode(bits); }
+};
+
+// Bottleneck (minimax) path: the value of a path is its heaviest arc, the lighter the better; (0, max, <) on non-negative lengths.
+template <typename T>
+struct BottleneckPath : ShortestPath<T> {
+    static constexpr uint32_t id = 1;
+
+    static constexpr T combine(T path, T arc) { return std::max(path, arc); }
+};
+
+// Widest path: the value of a path is its lightest arc, e.g. the capacity of a route, the heavier the better; (infinity, min, >).
+// Unreachable vertices have zero capacity, like the paths through an arc of zero capacity.
+template <typename T>
+struct WidestPath {
+    static constexpr uint32_t id = 2;
+
+    static constexpr T identity() { return WeightTraits<T>::infinity(); }
+    static constexpr T unreachable() { return WeightTraits<T>::zero(); }
+    static constexpr T combine(T path, T arc) { return std::min(path, arc); }
+
+    // Reversing the bits reverses the order.
+    static constexpr uint64_t encode(T len) { return ~WeightTraits<T>::encode(len); }
+    static constexpr T decode(uint64_t bits) { return WeightTraits<T>::decode(~bits); }
+};
+
+#if defined(PATH_ALGEBRA_BOTTLENECK)
+using Algebra = BottleneckPath<ActualLength>;
+#elif defined(PATH_ALGEBRA_WIDEST)
+using Algebra = WidestPath<ActualLength>;
+#else
+using Algebra = ShortestPath<ActualLength>;
+#endif
 
 // Arc compresses an edge in the graph.
 struct Arc {
@@ -53,6 +194,10 @@ struct Arc {
     ActualLength length;
 };
 
+// Edge is an arc together with its source, used while a Graph is being built.
+struct Edge {
+    VertexIndex from;
+    VertexIndex to;
+    ActualLength length;
+};
 
-// A list of vertices, used in the FindPivot function.
-using UList = std::unique_ptr<std::list<VertexIndex>>;
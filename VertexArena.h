@@ -0,0 +1,112 @@
+#pragma once
+
+
+#include "types.h"
+
+
+class VertexArena;
+
+
+/**
+ * @brief VertexBuffer is a contiguous run of vertices living in a VertexArena.
+ * It replaces the std::list based vertex lists used in FindPivot, so that appending a vertex allocates nothing.
+ *
+ * A buffer can only grow while it is the topmost buffer of its arena.
+ * Appending during iteration is allowed: the end of a range-for is checked against the current size,
+ * so vertices appended in the loop body are visited as well, just like with a std::list.
+ * The arena storage may be reallocated when growing, so iterators hold indices instead of pointers.
+ */
+class VertexBuffer {
+    VertexArena* arena = nullptr;
+    size_t first = 0; // The position of the first vertex in the arena.
+    size_t count = 0;
+
+    friend class VertexArena;
+
+    VertexBuffer(VertexArena* a, size_t f) : arena(a), first(f) {}
+
+public:
+
+    VertexBuffer() = default;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    VertexIndex operator[](size_t i) const;
+
+    // Appends a vertex, the buffer must be the topmost buffer of its arena.
+    void push_back(VertexIndex v);
+
+    struct Sentinel {};
+
+    class Iterator {
+        const VertexBuffer* buffer;
+        size_t i;
+    public:
+        Iterator(const VertexBuffer* b, size_t index) : buffer(b), i(index) {}
+        VertexIndex operator*() const { return (*buffer)[i]; }
+        Iterator& operator++() { ++i; return *this; }
+        bool operator!=(Sentinel) const { return i < buffer->size(); }
+        bool operator==(Sentinel s) const { return !(*this != s); }
+    };
+
+    Iterator begin() const { return { this, 0 }; }
+    Sentinel end() const { return {}; }
+};
+
+
+/**
+ * @brief VertexArena is a bump allocator of vertices for the buffers used during one solve().
+ * All buffers are stacked in one vector, whose capacity is kept across recursion frames and solves.
+ *
+ * Each recursion frame of BMSSP holds a Frame, which remembers the top of the arena on entry
+ * and releases everything allocated above it on exit. Buffers created in a frame must not outlive it.
+ */
+class VertexArena {
+    std::vector<VertexIndex> storage;
+
+    friend class VertexBuffer;
+
+public:
+
+    explicit VertexArena(size_t initialCapacity = 0) { storage.reserve(initialCapacity); }
+
+    VertexArena(const VertexArena&) = delete;
+    VertexArena& operator=(const VertexArena&) = delete;
+
+    // Starts a new empty buffer at the top of the arena.
+    VertexBuffer newBuffer() { return { this, storage.size() }; }
+
+    size_t getTop() const { return storage.size(); }
+
+    size_t getCapacity() const { return storage.capacity(); }
+
+    // Releases the buffers above mark, which must not be used afterwards.
+    void release(size_t mark) {
+        assert(mark <= storage.size() && "VertexArena can only be released downwards");
+        storage.resize(mark);
+    }
+
+    // Releases every buffer allocated during its lifetime when it goes out of scope.
+    class Frame {
+        VertexArena& arena;
+        size_t mark;
+    public:
+        explicit Frame(VertexArena& a) : arena(a), mark(a.getTop()) {}
+        ~Frame() { arena.release(mark); }
+        Frame(const Frame&) = delete;
+        Frame& operator=(const Frame&) = delete;
+    };
+};
+
+
+inline VertexIndex VertexBuffer::operator[](size_t i) const {
+    assert(i < count && "VertexBuffer index out of range");
+    return arena->storage[first + i];
+}
+
+inline void VertexBuffer::push_back(VertexIndex v) {
+    assert(arena && first + count == arena->storage.size() && "Only the topmost VertexBuffer can grow");
+    arena->storage.push_back(v);
+    ++ count;
+}
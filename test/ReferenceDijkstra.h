@@ -0,0 +1,27 @@
+#pragma once
+
+
+#include "../Graph.h"
+
+#include <queue>
+
+
+// Dijkstra from vertex 0 on the original graph under Algebra, as the reference of the tests.
+// A path is better if its encoding is smaller, and Algebra::combine saturates like the solver for integer weights.
+inline std::vector<ActualLength> dijkstra(const Graph& g) {
+	std::vector<ActualLength> best(g.getNumOfVertices(), Algebra::unreachable());
+	using Item = std::pair<uint64_t, VertexIndex>;
+	std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+	best[0] = Algebra::identity();
+	queue.push({ Algebra::encode(best[0]), 0 });
+	while (!queue.empty()) {
+		auto [bits, u] = queue.top();
+		queue.pop();
+		if (bits > Algebra::encode(best[u])) { continue; }
+		for (auto [v, w] : g.getNeighbors(u)) {
+			ActualLength through = Algebra::combine(best[u], w);
+			if (Algebra::encode(through) < Algebra::encode(best[v])) { best[v] = through; queue.push({ Algebra::encode(through), v }); }
+		}
+	}
+	return best;
+}
@@ -0,0 +1,77 @@
+#include "../BMSSP.h"
+
+#include <algorithm>
+#include <chrono>
+
+// Compares the selection policies, on whole solves and on the key distributions Block and FrontierManager select from.
+
+constexpr SelectionPolicy policies[] = { SelectionPolicy::StrictLinear, SelectionPolicy::IntroSelect, SelectionPolicy::FloydRivest, SelectionPolicy::Radix };
+
+template <typename F>
+double timeIt(F&& f) {
+	auto start = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Blocks hold the keys of a band of distances in no particular order.
+// Each sample is a random band of the final keys, either shuffled or only shuffled within small chunks,
+// like blocks built by consecutive batch-prepends.
+std::vector<std::vector<Length>> frontierSamples(const std::vector<Length>& sortedKeys, size_t width, bool chunked, std::mt19937& gen) {
+	std::vector<std::vector<Length>> samples;
+	std::uniform_int_distribution<size_t> offsetDist(0, sortedKeys.size() - width);
+	for (size_t i = 0; i < std::max<size_t>(1, 200000 / width); ++i) {
+		size_t offset = offsetDist(gen);
+		std::vector<Length> sample(sortedKeys.begin() + offset, sortedKeys.begin() + offset + width);
+		size_t chunk = chunked ? 16 : width;
+		for (size_t c = 0; c < width; c += chunk) { std::shuffle(sample.begin() + c, sample.begin() + std::min(width, c + chunk), gen); }
+		samples.push_back(std::move(sample));
+	}
+	return samples;
+}
+
+int main() {
+	const VertexIndex n = 10000;
+	genRandGraph2File("benchmark_graph.txt", n, 3 * n, 1.0, 10.0, 1);
+
+	std::vector<Length> keys;
+	for (auto policy : policies) {
+		BMSSP solver(Graph("benchmark_graph.txt"));
+		solver.setSelectionPolicy(policy);
+		double seconds = timeIt([&] { solver.solve(); });
+		std::cout << "solve\t" << getSelectionPolicyName(policy) << "\t" << seconds << " s\tpeak live Blocks " << solver.getPeakLiveBlocks() << std::endl;
+		if (keys.empty()) { for (VertexIndex v = 0; v < n; ++v) { keys.push_back(solver.getKey(v)); } }
+	}
+	std::sort(keys.begin(), keys.end());
+
+	// Heap frontiers on the lowest levels only, then on every level, and radix frontiers on every level.
+	std::vector<std::vector<FrontierKind>> frontierPolicies = {
+		{ FrontierKind::Blocks }, { FrontierKind::Blocks, FrontierKind::BinaryHeap, FrontierKind::Blocks },
+		{ FrontierKind::Blocks, FrontierKind::BinaryHeap, FrontierKind::BinaryHeap, FrontierKind::Blocks }, { FrontierKind::BinaryHeap },
+		{ FrontierKind::Radix } };
+	for (const auto& kinds : frontierPolicies) {
+		BMSSP solver(Graph("benchmark_graph.txt"));
+		solver.setSelectionPolicy(SelectionPolicy::FloydRivest);
+		solver.setFrontierPolicy(kinds);
+		double seconds = timeIt([&] { solver.solve(); });
+		std::cout << "solve\tfrontiers";
+		for (auto kind : kinds) { std::cout << " " << getFrontierKindName(kind); }
+		std::cout << "\t" << seconds << " s" << std::endl;
+	}
+
+	std::mt19937 gen(1);
+	for (size_t width : { 64, 1024, 8192 }) {
+		for (bool chunked : { false, true }) {
+			auto samples = frontierSamples(keys, width, chunked, gen);
+			for (size_t q : { width / 2, width / 8 + 1 }) {
+				for (auto policy : policies) {
+					auto copies = samples;
+					double seconds = timeIt([&] { for (auto& sample : copies) { selectMinQ(sample, q, policy); } });
+					std::cout << "select\twidth " << width << (chunked ? " chunked" : " shuffled") << "\tq " << q << "\t"
+						<< getSelectionPolicyName(policy) << "\t" << seconds * 1e9 / (samples.size() * width) << " ns/key" << std::endl;
+				}
+			}
+		}
+	}
+	return 0;
+}
@@ -2,14 +2,16 @@
 
 
 int main() {
-    auto base = std::make_shared<ManualLinkedListBase>(10);
+    DistanceTable dhat;
+    dhat.reset(10);
+    auto base = std::make_shared<ManualLinkedListBase>(dhat);
     base->debugPrint();
 
     auto list1 = base->newList();
     list1.add(1);
     list1.add(2);
 
-	// now: list 1: 2 -> 1; id : 10.
+	// now: list 1: 2 -> 1; id : 0.
     list1.debugPrint();
     base->debugPrint();
 
@@ -17,7 +19,7 @@ int main() {
     list2.add(1);
     list2.add(4);
 
-	// now: list 1: 2; id: 10. list 2: 4 -> 1, id: 11.
+	// now: list 1: 2; id: 0. list 2: 4 -> 1, id: 1.
     list1.debugPrint();
     list2.debugPrint();
     base->debugPrint();
@@ -28,7 +30,7 @@ int main() {
     list3 -> add(5);
     list3 -> add(1);
     
-	// now: list 1: 2; id: 10. list 2: 4; id: 11. list 3: 1 -> 5 -> 3, id: 12.
+	// now: list 1: 2; id: 0. list 2: 4; id: 1. list 3: 1 -> 5 -> 3, id: 2.
     list1.debugPrint();
     list2.debugPrint();
     list3->debugPrint();
@@ -36,7 +38,7 @@ int main() {
 
     list3.reset();
     
-	// now: list 1: 2; id: 10. list 2: 4; id: 11. blockPool: 12
+	// now: list 1: 2; id: 0. list 2: 4; id: 1. blockPool: 2
     base->debugPrint();
 
 	auto list4 = std::make_shared<ManualLinkedList>(base->newList());
@@ -49,7 +51,7 @@ int main() {
     list5->add(9);
 	list3->add(0);
 
-	// now: list 1: 2; id: 10. list 2: 4; id: 11. list 3: 0; id: 14. list 4: 7 -> 6; id: 12. list 5: 9 -> 8, id: 13.
+	// now: list 1: 2; id: 0. list 2: 4; id: 1. list 3: 0; id: 4. list 4: 7 -> 6; id: 2. list 5: 9 -> 8, id: 3.
     list1.debugPrint();
     list2.debugPrint();
     list3->debugPrint();
@@ -58,10 +60,10 @@ int main() {
     base->debugPrint();
 
 	list1.merge(list2);
-	list2.merge(*list4); // merging an nonempty list into an empty list, would cause their id to be swapped.
+	list2.merge(*list4); // merging a larger list into a smaller (here empty) list, would cause their id to be swapped.
 	list3->merge(*list5);
 
-	// now: list 1: 2 -> 4; id: 10. list 2: 7 -> 6; id: 12. list 3: 0 -> 9 -> 8; id: 14. list 4: empty; id: 11. list 5: empty, id: 13.
+	// now: list 1: 2 -> 4; id: 0. list 2: 7 -> 6; id: 2. list 3: 9 -> 8 -> 0; id: 3. list 4: empty; id: 1. list 5: empty, id: 4.
     list1.debugPrint();
     list2.debugPrint();
     list3->debugPrint();
@@ -73,7 +75,7 @@ int main() {
     list5.reset();
 	auto list6 = std::make_shared<ManualLinkedList>(base->newList());
 
-	// now: blockPool: 11; list 6: empty; id: 13.
+	// now: blockPool: 1; list 6: empty; id: 4.
     list1.debugPrint();
     list2.debugPrint();
     list3->debugPrint();
@@ -0,0 +1,36 @@
+#include "../BinaryGraph.h"
+#include "../BMSSP.h"
+#include "ReferenceDijkstra.h"
+
+// Built with WEIGHT_UINT32, so lengths are exact integers.
+static_assert(std::is_same_v<ActualLength, uint32_t>, "test10 requires WEIGHT_UINT32");
+
+int main() {
+	std::cout << "Sums saturate at infinity: " << std::boolalpha
+		<< (Weights::add(Weights::infinity() - 1, 5) == Weights::infinity() && Weights::add(2, 3) == 5) << std::endl;
+	std::cout << "Encoding keeps the order: " << (Length(7, 0, 1) < Length(8, 0, 0) && Length(8, 0, 0) < Length::infinity()) << std::endl;
+
+	genRandGraph2File("test_graph.txt", 3000, 9000, 1, 100, 1);
+	auto expected = dijkstra(Graph("test_graph.txt"));
+	for (auto policy : { SelectionPolicy::StrictLinear, SelectionPolicy::Radix }) {
+		BMSSP solver(Graph("test_graph.txt"));
+		solver.setSelectionPolicy(policy);
+		solver.solve();
+		bool allMatch = true;
+		for (VertexIndex v = 0; v < expected.size(); ++v) { allMatch &= solver.getLength(v) == expected[v]; }
+		std::cout << "BMSSP with integer weights and " << getSelectionPolicyName(policy) << " selection matches Dijkstra exactly: " << allMatch << std::endl;
+	}
+	for (auto kinds : { std::vector<FrontierKind>{ FrontierKind::Radix }, std::vector<FrontierKind>{ FrontierKind::Blocks, FrontierKind::Radix, FrontierKind::Blocks } }) {
+		BMSSP solver(Graph("test_graph.txt"));
+		solver.setFrontierPolicy(kinds);
+		solver.solve();
+		bool allMatch = true;
+		for (VertexIndex v = 0; v < expected.size(); ++v) { allMatch &= solver.getLength(v) == expected[v]; }
+		std::cout << "BMSSP with integer weights and radix frontiers on " << (kinds.size() == 1 ? "every level" : "level 1") << " matches Dijkstra exactly: " << allMatch << std::endl;
+	}
+
+	writeBinaryGraph("test_graph.bin", Graph("test_graph.txt"), false);
+	BinaryGraph bin = loadBinaryGraph("test_graph.bin");
+	std::cout << "Binary graph keeps integer lengths: " << (bin.graph.getLengths()[0] == Graph("test_graph.txt").getLengths()[0]) << std::endl;
+	return 0;
+}
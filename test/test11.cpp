@@ -0,0 +1,25 @@
+#include "../BMSSP.h"
+#include "ReferenceDijkstra.h"
+
+// Built once with PATH_ALGEBRA_WIDEST (test11) and once with PATH_ALGEBRA_BOTTLENECK (test12).
+static_assert(Algebra::id != ShortestPath<ActualLength>::id, "test11 requires a path algebra other than shortest path");
+
+const char* algebraName = Algebra::id == WidestPath<ActualLength>::id ? "widest path" : "bottleneck path";
+
+int main() {
+	std::cout << "Encoding keeps the order of " << algebraName << ": " << std::boolalpha
+		<< (Length(Algebra::identity(), 0, 1) < Length(Algebra::combine(Algebra::identity(), 5), 0, 0)
+			&& Length(Algebra::combine(Algebra::identity(), 5), 0, 0) < Length::infinity()) << std::endl;
+
+	genRandGraph2File("test_graph.txt", 3000, 9000, 1, 100, 1);
+	auto expected = dijkstra(Graph("test_graph.txt"));
+	for (auto frontier : { FrontierKind::Blocks, FrontierKind::BinaryHeap }) {
+		BMSSP solver(Graph("test_graph.txt"));
+		solver.setFrontierPolicy(frontier);
+		solver.solve();
+		bool allMatch = true;
+		for (VertexIndex v = 0; v < expected.size(); ++v) { allMatch &= solver.getLength(v) == expected[v]; }
+		std::cout << "BMSSP of " << algebraName << " with " << getFrontierKindName(frontier) << " frontier matches Dijkstra: " << allMatch << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,69 @@
+#include "../BinaryGraph.h"
+#include "../BMSSP.h"
+#include "ReferenceDijkstra.h"
+
+#include <fstream>
+
+// Built with VERTEX_INDEX_UINT32 and EDGE_INDEX_UINT32.
+static_assert(sizeof(VertexIndex) == 4 && sizeof(EdgeIndex) == 4, "test13 requires 32-bit indices");
+
+// Reads the header of a binary graph file.
+BinaryGraphHeader readHeader(const std::string& filename) {
+	BinaryGraphHeader header{};
+	std::ifstream(filename, std::ios::binary).read(reinterpret_cast<char*>(&header), sizeof(header));
+	return header;
+}
+
+// Whether loading a copy of a binary graph file, whose header is changed by patch, is rejected.
+template <typename F>
+bool rejectsPatchedHeader(const std::string& filename, F&& patch) {
+	std::ifstream fin(filename, std::ios::binary);
+	std::string bytes((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+	BinaryGraphHeader header = readHeader(filename);
+	patch(header);
+	bytes.replace(0, sizeof(header), reinterpret_cast<const char*>(&header), sizeof(header));
+	std::ofstream("test_graph_patched.bin", std::ios::binary | std::ios::trunc) << bytes;
+	try { loadBinaryGraph("test_graph_patched.bin"); }
+	catch (const std::runtime_error&) { return true; }
+	return false;
+}
+
+// Whether loading the text graph of the given content throws an exception of type E.
+template <typename E>
+bool loadThrows(const std::string& content) {
+	std::ofstream("test_graph_overflow.txt") << content;
+	try { Graph g("test_graph_overflow.txt"); }
+	catch (const E&) { return true; }
+	catch (...) {}
+	return false;
+}
+
+int main() {
+	genRandGraph2File("test_graph.txt", 3000, 9000, 1.0, 100.0, 1);
+	auto expected = dijkstra(Graph("test_graph.txt"));
+	for (auto mode : { ConstDegMode::Full, ConstDegMode::Selective }) {
+		BMSSP solver(Graph("test_graph.txt"), mode);
+		solver.solve();
+		bool allMatch = true;
+		for (VertexIndex v = 0; v < expected.size(); ++v) {
+			allMatch &= solver.getLength(v) == expected[v] || std::abs(solver.getLength(v) - expected[v]) <= 1e-9 * std::max<ActualLength>(1, expected[v]);
+		}
+		std::cout << "BMSSP with 32-bit indices matches Dijkstra under " << (mode == ConstDegMode::Full ? "Full" : "Selective")
+			<< " transformation: " << std::boolalpha << allMatch << std::endl;
+	}
+
+	convertText2Binary("test_graph.txt", "test_graph.bin");
+	BinaryGraph bin = loadBinaryGraph("test_graph.bin");
+	BinaryGraphHeader header = readHeader("test_graph.bin");
+	std::cout << "Binary graph records 32-bit indices: "
+		<< (header.vertexIndexBytes == 4 && header.edgeIndexBytes == 4 && bin.graph.getNumOfEdges() == 9000 && bin.constDegGraph.has_value()) << std::endl;
+	std::cout << "Binary graph of 64-bit vertex indices is rejected: "
+		<< rejectsPatchedHeader("test_graph.bin", [](BinaryGraphHeader& h) { h.vertexIndexBytes = 8; }) << std::endl;
+	std::cout << "Binary graph of 64-bit edge indices is rejected: "
+		<< rejectsPatchedHeader("test_graph.bin", [](BinaryGraphHeader& h) { h.edgeIndexBytes = 8; }) << std::endl;
+
+	std::cout << "Too many vertices is an overflow: " << loadThrows<std::overflow_error>("5000000000 1\n0 1 1\n") << std::endl;
+	std::cout << "Too many edges is an overflow: " << loadThrows<std::overflow_error>("2 5000000000\n0 1 1\n") << std::endl;
+	std::cout << "Vertex index beyond 32 bits is out of range: " << loadThrows<std::runtime_error>("2 1\n0 4294967297 1\n") << std::endl;
+	return 0;
+}
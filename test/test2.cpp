@@ -7,6 +7,7 @@ int main() {
 	g.addEdge(2, 3, 3.4);
 	g.addEdge(3, 4, 4.5);
 	g.addEdge(4, 0, 5.6);
+	g.finalize();
 	std::cout << "Original Graph:" << std::endl;
 	std::cout << g;
 	Graph transformedGraph = g.transform2ConstDeg();
@@ -22,11 +23,15 @@ int main() {
 	g2.addEdge(2, 4, 6);
 	g2.addEdge(0, 5, 2);
 	g2.addEdge(6, 0, 9);
+	g2.finalize();
 	std::cout << "Original Graph 2:" << std::endl;
 	std::cout << g2;
 	Graph transformedGraph2 = g2.transform2ConstDeg();
 	std::cout << "Transformed Graph 2:" << std::endl;
 	std::cout << transformedGraph2;
+	Graph selectiveGraph2 = g2.transform2ConstDeg(ConstDegMode::Selective);
+	std::cout << "Selectively transformed Graph 2:" << std::endl;
+	std::cout << selectiveGraph2;
 
 
 	genRandGraph2File("test_graph.txt", 10, 20, 1.0, 10.0, 1);
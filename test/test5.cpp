@@ -0,0 +1,39 @@
+#include "../BinaryGraph.h"
+#include "../BMSSP.h"
+
+// Checks that two graphs have exactly the same arcs in the same order.
+bool sameGraph(const Graph& a, const Graph& b) {
+	if (a.getNumOfVertices() != b.getNumOfVertices() || a.getNumOfEdges() != b.getNumOfEdges()) { return false; }
+	for (VertexIndex v = 0; v < a.getNumOfVertices(); ++v) {
+		auto na = a.getNeighbors(v), nb = b.getNeighbors(v);
+		if (na.size() != nb.size()) { return false; }
+		for (size_t i = 0; i < na.size(); ++i) {
+			if (na[i].to != nb[i].to || na[i].length != nb[i].length) { return false; }
+		}
+	}
+	return true;
+}
+
+int main() {
+	genRandGraph2File("test_graph.txt", 200, 600, 1.0, 10.0, 1);
+	convertText2Binary("test_graph.txt", "test_graph.bin");
+
+	Graph text("test_graph.txt");
+	BinaryGraph bin = loadBinaryGraph("test_graph.bin");
+	std::cout << "Graph section matches text: " << std::boolalpha << sameGraph(text, bin.graph) << std::endl;
+	std::cout << "Constant-degree section present: " << bin.constDegGraph.has_value() << std::endl;
+	std::cout << "Constant-degree section matches transform2ConstDeg: "
+		<< (bin.constDegGraph && sameGraph(text.transform2ConstDeg(ConstDegMode::Selective), *bin.constDegGraph)) << std::endl;
+
+	BMSSP fromText(std::move(text));
+	fromText.solve();
+	BMSSP fromBinary(std::move(bin.graph), std::move(*bin.constDegGraph));
+	fromBinary.solve();
+	bool allMatch = true;
+	for (VertexIndex v = 0; v < 200; ++v) { allMatch &= fromText.getLength(v) == fromBinary.getLength(v); }
+	std::cout << "BMSSP lengths match: " << allMatch << std::endl;
+
+	writeBinaryGraph("test_graph_nocd.bin", Graph("test_graph.txt"), false);
+	std::cout << "Constant-degree section omitted: " << !loadBinaryGraph("test_graph_nocd.bin").constDegGraph.has_value() << std::endl;
+	return 0;
+}
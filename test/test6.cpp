@@ -0,0 +1,43 @@
+#include "../IndexedHeap.h"
+
+// Runs random pushOrDecrease / pop operations on heap and checks every pop against a brute-force reference.
+// Keys are (key, vertex) pairs so that the minimum is unique.
+template <typename Heap>
+bool checkHeap(Heap& heap, size_t numOfVertices, size_t maxSize, size_t rounds, unsigned seed) {
+	std::mt19937 gen(seed);
+	std::uniform_int_distribution<int> keyDist(0, 1000);
+	std::uniform_int_distribution<VertexIndex> vertexDist(0, numOfVertices - 1);
+	std::map<VertexIndex, int> reference;
+	for (size_t round = 0; round < rounds; ++round) {
+		if (round % 100 == 0) { heap.clear(); reference.clear(); }
+		if (reference.size() < maxSize && gen() % 3) {
+			VertexIndex v = vertexDist(gen);
+			int key = keyDist(gen);
+			heap.pushOrDecrease(v, std::make_pair(key, v));
+			auto it = reference.find(v);
+			if (it == reference.end()) { reference[v] = key; }
+			else { it->second = std::min(it->second, key); }
+		}
+		else if (!reference.empty()) {
+			auto expected = std::min_element(reference.begin(), reference.end(),
+				[](const auto& a, const auto& b) { return std::make_pair(a.second, a.first) < std::make_pair(b.second, b.first); });
+			auto popped = heap.pop();
+			if (popped.vertex != expected->first || popped.key.first != expected->second) { return false; }
+			reference.erase(expected);
+		}
+		if (heap.size() != reference.size()) { return false; }
+	}
+	return true;
+}
+
+int main() {
+	IndexedHeap<std::pair<int, VertexIndex>> heap(1000);
+	std::cout << "IndexedHeap matches reference: " << std::boolalpha << checkHeap(heap, 1000, 1000, 100000, 1) << std::endl;
+
+	IndexedHeap<std::pair<int, VertexIndex>, 2> binaryHeap(50);
+	std::cout << "Binary IndexedHeap matches reference: " << checkHeap(binaryHeap, 50, 50, 100000, 2) << std::endl;
+
+	InlineIndexedHeap<std::pair<int, VertexIndex>, 16> inlineHeap;
+	std::cout << "InlineIndexedHeap matches reference: " << checkHeap(inlineHeap, 1000, 16, 100000, 3) << std::endl;
+	return 0;
+}
@@ -0,0 +1,65 @@
+#include "../Selection.h"
+
+#include <algorithm>
+
+// Checks selectMinQ with every policy and partitionKeys on random keys against std::sort, with few distinct lengths so that ties are common.
+// The scratch is shared by all checks, as the solver shares one across its selections.
+bool checkSelection(std::mt19937& gen, size_t n, int distinctLengths, SelectionScratch& scratchOfSolver) {
+	std::uniform_int_distribution<int> lengthDist(0, distinctLengths);
+	std::uniform_int_distribution<size_t> hopDist(0, 3);
+	std::vector<Length> keys;
+	for (size_t i = 0; i < n; ++i) { keys.emplace_back(ActualLength(lengthDist(gen)), hopDist(gen), i % 7); }
+	std::vector<Length> sorted = keys;
+	std::sort(sorted.begin(), sorted.end());
+
+	std::uniform_int_distribution<size_t> qDist(1, n);
+	size_t q = qDist(gen);
+	for (auto policy : { SelectionPolicy::StrictLinear, SelectionPolicy::IntroSelect, SelectionPolicy::FloydRivest, SelectionPolicy::Radix }) {
+		std::vector<Length> selected = keys;
+		if (selectMinQ(selected, q, policy) != sorted[q - 1]) { return false; }
+		for (size_t i = 0; i < n; ++i) {
+			if ((i < q && selected[i] > sorted[q - 1]) || (i >= q && selected[i] < sorted[q - 1])) { return false; }
+		}
+
+		selected = keys;
+		auto result = selectMinQ(selected, q, policy, scratchOfSolver);
+		size_t expectedSplit = std::upper_bound(sorted.begin(), sorted.end(), sorted[q - 1]) - sorted.begin();
+		if (result.pivot != sorted[q - 1] || result.split != expectedSplit) { return false; }
+		for (size_t i = 0; i < n; ++i) {
+			if ((selected[i] <= result.pivot) != (i < result.split)) { return false; }
+		}
+	}
+
+	const Length& pivot = keys[qDist(gen) - 1];
+	for (bool strict : { false, true }) {
+		std::vector<Length> parted = keys, scratch(n + 8);
+		size_t numLeft = partitionKeys(parted.data(), n, pivot, strict, scratch.data());
+		size_t expected = strict ? std::lower_bound(sorted.begin(), sorted.end(), pivot) - sorted.begin()
+			: std::upper_bound(sorted.begin(), sorted.end(), pivot) - sorted.begin();
+		if (numLeft != expected) { return false; }
+		for (size_t i = 0; i < n; ++i) {
+			bool left = strict ? parted[i] < pivot : parted[i] <= pivot;
+			if (left != (i < numLeft)) { return false; }
+		}
+		std::sort(parted.begin(), parted.end());
+		if (parted != sorted) { return false; }
+	}
+	return true;
+}
+
+int main() {
+	for (auto kernel : { PartitionKernel::Scalar, PartitionKernel::AVX2, PartitionKernel::AVX512 }) {
+		if (!setPartitionKernel(kernel)) {
+			std::cout << getPartitionKernelName(kernel) << ": not supported" << std::endl;
+			continue;
+		}
+		std::mt19937 gen(1);
+		SelectionScratch scratch;
+		bool ok = true;
+		for (size_t n : { 1, 2, 3, 5, 31, 33, 100, 1000, 4099, 20000 }) {
+			for (int distinct : { 1, 10, 1000000 }) { ok &= checkSelection(gen, n, distinct, scratch); }
+		}
+		std::cout << getPartitionKernelName(kernel) << ": " << (ok ? "ok" : "failed") << std::endl;
+	}
+	return 0;
+}
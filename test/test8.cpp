@@ -0,0 +1,101 @@
+#include "../BMSSP.h"
+#include "ReferenceDijkstra.h"
+
+#include <algorithm>
+
+// Built with BLOCK_CONTIGUOUS_STORAGE, so Blocks are KeyedLists.
+static_assert(std::is_same_v<BlockList, KeyedList>, "test8 requires BLOCK_CONTIGUOUS_STORAGE");
+
+// Checks that every entry of list holds its vertex's key in dhat, and that the lists hold expected in some order.
+bool sameItems(const KeyedList& list, const DistanceTable& dhat, std::vector<VertexIndex> expected) {
+	std::vector<VertexIndex> items;
+	for (const auto& key : list.getKeys()) {
+		if (key != dhat[key.getIndex()]) { return false; }
+		items.push_back(key.getIndex());
+	}
+	std::sort(items.begin(), items.end());
+	std::sort(expected.begin(), expected.end());
+	return items == expected;
+}
+
+int main() {
+	DistanceTable dhat;
+	dhat.reset(10);
+	auto base = std::make_shared<KeyedListBase>(dhat);
+
+	auto list1 = base->newList();
+	auto list2 = base->newList();
+	for (VertexIndex v : { 1, 2, 3, 4 }) { list1.add(v); }
+	list2.add(2); // moves 2 out of list1, and 4 fills its place.
+	list2.add(5);
+	std::cout << "Add moves between lists: " << std::boolalpha
+		<< (sameItems(list1, dhat, { 1, 3, 4 }) && sameItems(list2, dhat, { 2, 5 })) << std::endl;
+
+	// Keys of unreached vertices are infinite, so the maximum of list1 is the key of 4.
+	Length key3 = Length::zero().relax(3, 1.5);
+	base->decreaseKey(3, key3);
+	dhat.commit(0, 3, key3);
+	std::cout << "decreaseKey keeps the minimum: " << (!list1.getExtremes().dirty && list1.getExtremes().min == key3) << std::endl;
+	list1.erase(1);
+	std::cout << "Erase and decreaseKey: " << (sameItems(list1, dhat, { 3, 4 })) << std::endl;
+	list1.erase(4);
+	std::cout << "Erasing the maximum makes the extremes dirty: " << list1.getExtremes().dirty << std::endl;
+	list1.add(4);
+
+	size_t visited = 0;
+	for (auto it = list1.begin(); it != list1.end(); ) {
+		auto curr = *it;
+		++ it;
+		list2.add(curr); // removes the current vertex while iterating.
+		++ visited;
+	}
+	std::cout << "Iteration survives removals: " << (visited == 2 && list1.empty() && sameItems(list2, dhat, { 2, 3, 4, 5 })) << std::endl;
+
+	list1.add(6);
+	list1.merge(list2);
+	std::cout << "Merge: " << (list2.empty() && sameItems(list1, dhat, { 2, 3, 4, 5, 6 })) << std::endl;
+	{
+		auto list3 = base->newList();
+		list3.add(7);
+	}
+	auto list4 = base->newList(); // reuses the list recycled above, now empty.
+	list4.add(8);
+	std::cout << "Recycled list: " << (sameItems(list4, dhat, { 8 })) << std::endl;
+
+	ObjectPool<std::vector<int>> pool;
+	auto first = pool.make(3, 1);
+	std::vector<int>* firstAddress = first.get();
+	{
+		auto second = pool.make(2, 2);
+		auto copy = second;
+	}
+	first = {}; // both slots are free again.
+	auto third = pool.make(1, 3);
+	std::cout << "ObjectPool reuses slots: " << (third.get() == firstAddress && pool.getNumOfLive() == 1 && pool.getPeakLive() == 2 && pool.getCapacity() == 64) << std::endl;
+
+	genRandGraph2File("test_graph.txt", 2000, 6000, 1.0, 10.0, 1);
+	auto expected = dijkstra(Graph("test_graph.txt"));
+	BMSSP solver(Graph("test_graph.txt"));
+	auto matchesDijkstra = [&]() {
+		bool allMatch = true;
+		for (VertexIndex v = 0; v < expected.size(); ++v) { allMatch &= solver.getLength(v) == expected[v] || std::abs(solver.getLength(v) - expected[v]) <= 1e-6; }
+		return allMatch;
+	};
+	solver.solve();
+	std::cout << "BMSSP with contiguous Blocks matches Dijkstra: " << matchesDijkstra() << std::endl;
+	std::cout << "Peak live Blocks: " << solver.getPeakLiveBlocks() << std::endl;
+
+	solver.setFrontierPolicy(FrontierKind::BinaryHeap);
+	solver.resetDhat();
+	solver.solve();
+	std::cout << "BMSSP with heap frontiers matches Dijkstra: " << matchesDijkstra() << std::endl;
+	solver.setFrontierPolicy(std::vector<FrontierKind>{ FrontierKind::Blocks, FrontierKind::BinaryHeap, FrontierKind::Blocks });
+	solver.resetDhat();
+	solver.solve();
+	std::cout << "BMSSP with a heap frontier on level 1 matches Dijkstra: " << matchesDijkstra() << std::endl;
+	solver.setFrontierPolicy(FrontierKind::Radix);
+	solver.resetDhat();
+	solver.solve();
+	std::cout << "BMSSP with radix frontiers matches Dijkstra: " << matchesDijkstra() << std::endl;
+	return 0;
+}
@@ -0,0 +1,45 @@
+#include "../FlatMap.h"
+
+// Runs random insert / popFront / upperBound operations on a FlatMap and checks each against std::map.
+// Small leaves make splits and recycled leaves frequent.
+template <size_t LEAF_SIZE>
+bool checkFlatMap(size_t maxKey, size_t rounds, unsigned seed) {
+	std::mt19937 gen(seed);
+	std::uniform_int_distribution<int> keyDist(0, static_cast<int>(maxKey));
+	FlatMap<int, int, LEAF_SIZE> map;
+	std::map<int, int> reference;
+	for (size_t round = 0; round < rounds; ++round) {
+		if (round % 5000 == 0) { map.clear(); reference.clear(); }
+		int key = keyDist(gen);
+		switch (gen() % 4) {
+		case 0:
+		case 1:
+			map.insert(key, static_cast<int>(round));
+			reference[key] = static_cast<int>(round);
+			break;
+		case 2:
+			if (!reference.empty()) {
+				if (map.frontKey() != reference.begin()->first || map.front() != reference.begin()->second) { return false; }
+				map.popFront();
+				reference.erase(reference.begin());
+			}
+			break;
+		default: {
+			auto it = reference.upper_bound(key);
+			int* found = map.upperBound(key);
+			if ((it == reference.end()) != (found == nullptr) || (found && *found != it->second)) { return false; }
+		}
+		}
+		if (map.size() != reference.size()) { return false; }
+	}
+	std::vector<std::pair<int, int>> entries;
+	map.forEach([&](int key, int value) { entries.emplace_back(key, value); });
+	return entries == std::vector<std::pair<int, int>>(reference.begin(), reference.end());
+}
+
+int main() {
+	std::cout << "FlatMap matches std::map: " << std::boolalpha << checkFlatMap<16>(1000, 200000, 1) << std::endl;
+	std::cout << "FlatMap with leaves of 2 matches std::map: " << checkFlatMap<2>(100, 200000, 2) << std::endl;
+	std::cout << "FlatMap with sparse keys matches std::map: " << checkFlatMap<4>(1000000, 200000, 3) << std::endl;
+	return 0;
+}